@@ -4,6 +4,7 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'ID3D11ShaderResourceView*' as ImTextureID. Read the FAQ about ImTextureID in imgui.cpp.
 //  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bits indices.
+//  [X] Renderer: Single channel font texture (1 byte per texel). Block-compressed font texture (ImFontAtlasFlags_CompressBC4).
 
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp
@@ -11,6 +12,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2019-10-21: DirectX11: Upload the font texture as DXGI_FORMAT_R8_UNORM (or DXGI_FORMAT_BC4_UNORM with ImFontAtlasFlags_CompressBC4) instead of RGBA32, expanded to (1,1,1,alpha) by a dedicated pixel shader.
 //  2019-08-01: DirectX11: Fixed code querying the Geometry Shader state (would generally error with Debug layer enabled).
 //  2019-07-21: DirectX11: Backup, clear and restore Geometry Shader is any is bound when calling ImGui_ImplDX10_RenderDrawData. Clearing Hull/Domain/Compute shaders without backup/restore.
 //  2019-05-29: DirectX11: Added support for large mesh (64K+ vertices), enable ImGuiBackendFlags_RendererHasVtxOffset flag.
@@ -48,6 +50,8 @@ static ID3D11InputLayout*       g_pInputLayout = NULL;
 static ID3D11Buffer*            g_pVertexConstantBuffer = NULL;
 static ID3D10Blob*              g_pPixelShaderBlob = NULL;
 static ID3D11PixelShader*       g_pPixelShader = NULL;
+static ID3D10Blob*              g_pPixelShaderFontBlob = NULL;
+static ID3D11PixelShader*       g_pPixelShaderFont = NULL;     // Same as g_pPixelShader but sampling the single channel font texture as (1,1,1,alpha)
 static ID3D11SamplerState*      g_pFontSampler = NULL;
 static ID3D11ShaderResourceView*g_pFontTextureView = NULL;
 static ID3D11RasterizerState*   g_pRasterizerState = NULL;
@@ -225,9 +229,11 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 
     // Render command lists
     // (Because we merged all buffers into a single one, we maintain our own offset into them)
+    // (We track the bound pixel shader to only switch it when going from the font texture to user textures or vice-versa)
     int global_idx_offset = 0;
     int global_vtx_offset = 0;
     ImVec2 clip_off = draw_data->DisplayPos;
+    ID3D11PixelShader* current_ps = g_pPixelShader;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
@@ -239,9 +245,14 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
+                {
                     ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
+                    current_ps = g_pPixelShader;
+                }
                 else
+                {
                     pcmd->UserCallback(cmd_list, pcmd);
+                }
             }
             else
             {
@@ -249,8 +260,14 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                 const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
                 ctx->RSSetScissorRects(1, &r);
 
-                // Bind texture, Draw
+                // Bind texture and matching pixel shader, Draw
                 ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
+                ID3D11PixelShader* ps = (texture_srv == g_pFontTextureView) ? g_pPixelShaderFont : g_pPixelShader;
+                if (ps != current_ps)
+                {
+                    ctx->PSSetShader(ps, NULL, 0);
+                    current_ps = ps;
+                }
                 ctx->PSSetShaderResources(0, 1, &texture_srv);
                 ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
             }
@@ -282,10 +299,27 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 static void ImGui_ImplDX11_CreateFontsTexture()
 {
     // Build texture atlas
+    // We upload the Alpha8 data in a single channel texture (or its BC4 encoding if requested and supported), g_pPixelShaderFont expands it to (1,1,1,alpha).
     ImGuiIO& io = ImGui::GetIO();
+    DXGI_FORMAT format = DXGI_FORMAT_R8_UNORM;
+    UINT format_support = 0;
+    if ((io.Fonts->Flags & ImFontAtlasFlags_CompressBC4) && !(io.Fonts->Flags & ImFontAtlasFlags_DynamicGlyphs))
+        if (g_pd3dDevice->CheckFormatSupport(DXGI_FORMAT_BC4_UNORM, &format_support) == S_OK && (format_support & D3D11_FORMAT_SUPPORT_TEXTURE2D))
+            format = DXGI_FORMAT_BC4_UNORM;
+
     unsigned char* pixels;
     int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    UINT pitch;
+    if (format == DXGI_FORMAT_BC4_UNORM)
+    {
+        io.Fonts->GetTexDataAsBC4(&pixels, &width, &height);
+        pitch = (UINT)(width / 4) * 8; // 8 bytes per 4x4 block
+    }
+    else
+    {
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        pitch = (UINT)width;
+    }
 
     // Upload texture to graphics system
     {
@@ -295,7 +329,7 @@ static void ImGui_ImplDX11_CreateFontsTexture()
         desc.Height = height;
         desc.MipLevels = 1;
         desc.ArraySize = 1;
-        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.Format = format;
         desc.SampleDesc.Count = 1;
         desc.Usage = D3D11_USAGE_DEFAULT;
         desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
@@ -304,14 +338,14 @@ static void ImGui_ImplDX11_CreateFontsTexture()
         ID3D11Texture2D *pTexture = NULL;
         D3D11_SUBRESOURCE_DATA subResource;
         subResource.pSysMem = pixels;
-        subResource.SysMemPitch = desc.Width * 4;
+        subResource.SysMemPitch = pitch;
         subResource.SysMemSlicePitch = 0;
         g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
 
         // Create texture view
         D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
         ZeroMemory(&srvDesc, sizeof(srvDesc));
-        srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        srvDesc.Format = format;
         srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
         srvDesc.Texture2D.MipLevels = desc.MipLevels;
         srvDesc.Texture2D.MostDetailedMip = 0;
@@ -434,6 +468,31 @@ bool    ImGui_ImplDX11_CreateDeviceObjects()
             return false;
     }
 
+    // Create the pixel shader used with the font texture (single channel, sampled as alpha)
+    {
+        static const char* pixelShader =
+            "struct PS_INPUT\
+            {\
+            float4 pos : SV_POSITION;\
+            float4 col : COLOR0;\
+            float2 uv  : TEXCOORD0;\
+            };\
+            sampler sampler0;\
+            Texture2D texture0;\
+            \
+            float4 main(PS_INPUT input) : SV_Target\
+            {\
+            float4 out_col = input.col * float4(1.0f, 1.0f, 1.0f, texture0.Sample(sampler0, input.uv).r); \
+            return out_col; \
+            }";
+
+        D3DCompile(pixelShader, strlen(pixelShader), NULL, NULL, NULL, "main", "ps_4_0", 0, 0, &g_pPixelShaderFontBlob, NULL);
+        if (g_pPixelShaderFontBlob == NULL)
+            return false;
+        if (g_pd3dDevice->CreatePixelShader((DWORD*)g_pPixelShaderFontBlob->GetBufferPointer(), g_pPixelShaderFontBlob->GetBufferSize(), NULL, &g_pPixelShaderFont) != S_OK)
+            return false;
+    }
+
     // Create the blending setup
     {
         D3D11_BLEND_DESC desc;
@@ -495,6 +554,8 @@ void    ImGui_ImplDX11_InvalidateDeviceObjects()
     if (g_pRasterizerState) { g_pRasterizerState->Release(); g_pRasterizerState = NULL; }
     if (g_pPixelShader) { g_pPixelShader->Release(); g_pPixelShader = NULL; }
     if (g_pPixelShaderBlob) { g_pPixelShaderBlob->Release(); g_pPixelShaderBlob = NULL; }
+    if (g_pPixelShaderFont) { g_pPixelShaderFont->Release(); g_pPixelShaderFont = NULL; }
+    if (g_pPixelShaderFontBlob) { g_pPixelShaderFontBlob->Release(); g_pPixelShaderFontBlob = NULL; }
     if (g_pVertexConstantBuffer) { g_pVertexConstantBuffer->Release(); g_pVertexConstantBuffer = NULL; }
     if (g_pInputLayout) { g_pInputLayout->Release(); g_pInputLayout = NULL; }
     if (g_pVertexShader) { g_pVertexShader->Release(); g_pVertexShader = NULL; }
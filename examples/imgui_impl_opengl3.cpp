@@ -6,6 +6,9 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID in imgui.cpp.
 //  [x] Renderer: Desktop GL only: Support for large meshes (64k+ vertices) with 16-bits indices.
+//  [X] Renderer: Partial font texture updates for dynamic font atlases (ImFontAtlasFlags_DynamicGlyphs).
+//  [X] Renderer: Signed distance field fonts (ImFontAtlasFlags_SDF).
+//  [X] Renderer: GL 3.3+ and GL ES 3.0+: Single channel font texture (1 byte per texel). Desktop GL 3.3+: Block-compressed font texture (ImFontAtlasFlags_CompressBC4).
 
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp.
@@ -13,6 +16,9 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2019-10-21: OpenGL: Upload the font texture as a single channel swizzled to (1,1,1,alpha) on GL 3.3+/GL ES 3.0+ instead of RGBA32. Upload it compressed as RGTC1 on desktop GL 3.3+ with ImFontAtlasFlags_CompressBC4.
+//  2019-10-18: OpenGL: Threshold the alpha of the font texture in the fragment shader when using signed distance field fonts (ImFontAtlasFlags_SDF). GL ES 2.0 without GL_OES_standard_derivatives gets the edge width from the CPU.
+//  2019-10-18: OpenGL: Upload font texture rows modified by dynamic font atlases (ImFontAtlasFlags_DynamicGlyphs) before rendering.
 //  2019-09-22: OpenGL: Detect default GL loader using __has_include compiler facility.
 //  2019-09-16: OpenGL: Tweak initialization code to allow application calling ImGui_ImplOpenGL3_CreateFontsTexture() before the first NewFrame() call.
 //  2019-05-29: OpenGL: Desktop GL only: Added support for large mesh (64K+ vertices), enable ImGuiBackendFlags_RendererHasVtxOffset flag.
@@ -68,6 +74,7 @@
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
 #include <stdio.h>
+#include <string.h>     // strncmp
 #if defined(_MSC_VER) && _MSC_VER <= 1500 // MSVC 2008 or earlier
 #include <stddef.h>     // intptr_t
 #else
@@ -126,11 +133,20 @@
 #define IMGUI_IMPL_OPENGL_HAS_DRAW_WITH_BASE_VERTEX     1
 #endif
 
+// Desktop GL 3.3+ and GL ES 3.0+ can swizzle texture channels, so we can upload the font atlas as a single channel texture.
+#if defined(IMGUI_IMPL_OPENGL_ES2) || !defined(GL_TEXTURE_SWIZZLE_R)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_TEXTURE_SWIZZLE      0
+#else
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_TEXTURE_SWIZZLE      1
+#endif
+
 // OpenGL Data
 static char         g_GlslVersionString[32] = "";
+static GLint        g_GlVersion = 0;                    // Major * 100 + Minor * 10, queried by ImGui_ImplOpenGL3_Init(). e.g. 330 for GL 3.3 or GL ES 3.3.
 static GLuint       g_FontTexture = 0;
+static GLenum       g_FontTextureFormat = 0;            // GL_RGBA, GL_RED (swizzled) or GL_COMPRESSED_RED_RGTC1 (swizzled)
 static GLuint       g_ShaderHandle = 0, g_VertHandle = 0, g_FragHandle = 0;
-static int          g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;                                // Uniforms location
+static int          g_AttribLocationTex = 0, g_AttribLocationTexSdf = 0, g_AttribLocationTexSdfWidth = 0, g_AttribLocationProjMtx = 0; // Uniforms location
 static int          g_AttribLocationVtxPos = 0, g_AttribLocationVtxUV = 0, g_AttribLocationVtxColor = 0; // Vertex attributes location
 static unsigned int g_VboHandle = 0, g_ElementsHandle = 0;
 
@@ -182,6 +198,16 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
     GLint current_texture;
     glGetIntegerv(GL_TEXTURE_BINDING_2D, &current_texture);
 
+    // Query GL version. We parse the string because GL_MAJOR_VERSION/GL_MINOR_VERSION are not available before GL 3.0 / GL ES 3.0.
+    if (const char* gl_version = (const char*)glGetString(GL_VERSION))
+    {
+        int major = 0, minor = 0;
+        if (strncmp(gl_version, "OpenGL ES ", 10) == 0)
+            gl_version += 10;
+        if (sscanf(gl_version, "%d.%d", &major, &minor) == 2)
+            g_GlVersion = major * 100 + minor * 10;
+    }
+
     return true;
 }
 
@@ -225,7 +251,19 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     };
     glUseProgram(g_ShaderHandle);
     glUniform1i(g_AttribLocationTex, 0);
+    glUniform1i(g_AttribLocationTexSdf, 0);
     glUniformMatrix4fv(g_AttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+
+    // GL ES 2.0 without GL_OES_standard_derivatives can't compute fwidth() for distance field fonts: pass the change of the distance value per framebuffer pixel instead.
+    // The atlas stores 128/TexSdfSpread per texel (see ImFontAtlasFlags_SDF). We assume glyphs are drawn at their baked size times the global and default font scales,
+    // so ImGui::SetWindowFontScale() and other fonts' Scale won't be accounted for on those targets.
+    ImGuiIO& io = ImGui::GetIO();
+    if (g_AttribLocationTexSdfWidth >= 0 && (io.Fonts->Flags & ImFontAtlasFlags_SDF) && io.Fonts->TexSdfSpread > 0)
+    {
+        const ImFont* font = io.FontDefault ? io.FontDefault : (io.Fonts->Fonts.Size > 0 ? io.Fonts->Fonts[0] : NULL);
+        const float texels_to_fb_pixels = io.FontGlobalScale * (font ? font->Scale : 1.0f) * draw_data->FramebufferScale.x;
+        glUniform1f(g_AttribLocationTexSdfWidth, (128.0f / io.Fonts->TexSdfSpread) / 255.0f / (texels_to_fb_pixels > 0.01f ? texels_to_fb_pixels : 0.01f));
+    }
 #ifdef GL_SAMPLER_BINDING
     glBindSampler(0, 0); // We use combined texture/sampler state. Applications using GL 3.3 may set that otherwise.
 #endif
@@ -246,6 +284,37 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     glVertexAttribPointer(g_AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
 }
 
+// Upload texels modified by the dynamic glyph cache (ImFontAtlasFlags_DynamicGlyphs) during the frame.
+// We upload whole rows because GL ES 2.0 doesn't support GL_UNPACK_ROW_LENGTH. Texture binding is restored by the caller.
+static void ImGui_ImplOpenGL3_UpdateFontsTexture()
+{
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    if (!atlas->HasTexUpdates() || g_FontTexture == 0)
+        return;
+    IM_ASSERT(g_FontTextureFormat != 0);
+    unsigned char* pixels;
+    int width, height, bytes_per_pixel;
+    if (g_FontTextureFormat == GL_RGBA)
+        atlas->GetTexDataAsRGBA32(&pixels, &width, &height, &bytes_per_pixel);
+    else
+        atlas->GetTexDataAsAlpha8(&pixels, &width, &height, &bytes_per_pixel);
+    GLint last_unpack_alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_unpack_alignment);
+    glBindTexture(GL_TEXTURE_2D, g_FontTexture);
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int n = 0; n < atlas->TexDirtyRects.Size; n++)
+    {
+        const int y0 = (int)atlas->TexDirtyRects[n].y;
+        const int y1 = (int)atlas->TexDirtyRects[n].w;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0, width, y1 - y0, g_FontTextureFormat, GL_UNSIGNED_BYTE, pixels + (size_t)y0 * width * bytes_per_pixel);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, last_unpack_alignment);
+    atlas->ClearTexDirtyRects();
+}
+
 // OpenGL3 Render function.
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly, in order to be able to run within any OpenGL engine that doesn't do so.
@@ -291,6 +360,9 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         clip_origin_lower_left = false;
 #endif
 
+    // Upload font texture updates
+    ImGui_ImplOpenGL3_UpdateFontsTexture();
+
     // Setup desired GL state
     // Recreate the VAO every time (this is to easily allow multiple GL contexts to be rendered to. VAO are not shared among GL contexts)
     // The renderer would actually work without any VAO bound, but then our VertexAttrib calls would overwrite the default one currently bound.
@@ -300,6 +372,10 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 #endif
     ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
 
+    // Font texture holding signed distance fields, if any
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    const ImTextureID sdf_texture_id = (atlas->Flags & ImFontAtlasFlags_SDF) ? atlas->TexID : (ImTextureID)NULL;
+
     // Will project scissor/clipping rectangles into framebuffer space
     ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
     ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
@@ -344,6 +420,7 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 
                     // Bind texture, Draw
                     glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
+                    glUniform1i(g_AttribLocationTexSdf, (sdf_texture_id != NULL && pcmd->TextureId == sdf_texture_id) ? 1 : 0);
 #if IMGUI_IMPL_OPENGL_HAS_DRAW_WITH_BASE_VERTEX
                     glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset);
 #else
@@ -385,15 +462,44 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 
 bool ImGui_ImplOpenGL3_CreateFontsTexture()
 {
-    // Build texture atlas
+    // Select texture format
+    // - GL 3.3+ and GL ES 3.0+: Alpha8 data in a single channel texture, swizzled to (1,1,1,alpha) when sampling. Saves 75% of the memory compared to RGBA32.
+    // - Desktop GL 3.3+ and ImFontAtlasFlags_CompressBC4: block-compressed RGTC1 texture (core since GL 3.0), swizzled the same way. Saves another 50%.
+    // - Otherwise: RGBA32 data, which is more likely to be compatible with user's existing shaders if you reuse the texture.
     ImGuiIO& io = ImGui::GetIO();
+    ImFontAtlas* atlas = io.Fonts;
+    g_FontTextureFormat = GL_RGBA;
+#if IMGUI_IMPL_OPENGL_MAY_HAVE_TEXTURE_SWIZZLE
+#if defined(IMGUI_IMPL_OPENGL_ES3)
+    if (g_GlVersion >= 300)
+        g_FontTextureFormat = GL_RED;
+#else
+    if (g_GlVersion >= 330)
+        g_FontTextureFormat = GL_RED;
+#ifdef GL_COMPRESSED_RED_RGTC1
+    if (g_FontTextureFormat == GL_RED && (atlas->Flags & ImFontAtlasFlags_CompressBC4) && !(atlas->Flags & ImFontAtlasFlags_DynamicGlyphs))
+        g_FontTextureFormat = GL_COMPRESSED_RED_RGTC1;
+#endif
+#endif
+#endif
+
+    // Build texture atlas
     unsigned char* pixels;
-    int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);   // Load as RGBA 32-bits (75% of the memory is wasted, but default font is so small) because it is more likely to be compatible with user's existing shaders. If your ImTextureId represent a higher-level concept than just a GL texture id, consider calling GetTexDataAsAlpha8() instead to save on GPU memory.
+    int width, height, size = 0;
+    if (g_FontTextureFormat == GL_RGBA)
+        atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+#ifdef GL_COMPRESSED_RED_RGTC1
+    else if (g_FontTextureFormat == GL_COMPRESSED_RED_RGTC1)
+        atlas->GetTexDataAsBC4(&pixels, &width, &height, &size);
+#endif
+    else
+        atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+    IM_UNUSED(size);
 
     // Upload texture to graphics system
-    GLint last_texture;
+    GLint last_texture, last_unpack_alignment;
     glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_unpack_alignment);
     glGenTextures(1, &g_FontTexture);
     glBindTexture(GL_TEXTURE_2D, g_FontTexture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -401,7 +507,27 @@ bool ImGui_ImplOpenGL3_CreateFontsTexture()
 #ifdef GL_UNPACK_ROW_LENGTH
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 #endif
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+#if IMGUI_IMPL_OPENGL_MAY_HAVE_TEXTURE_SWIZZLE
+    if (g_FontTextureFormat != GL_RGBA)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ONE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ONE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ONE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
+        if (g_FontTextureFormat == GL_RED)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+#ifdef GL_COMPRESSED_RED_RGTC1
+        else
+            glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RED_RGTC1, width, height, 0, size, pixels);
+#endif
+    }
+    else
+#endif
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, last_unpack_alignment);
 
     // Store our identifier
     io.Fonts->TexID = (ImTextureID)(intptr_t)g_FontTexture;
@@ -531,47 +657,71 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
         "    gl_Position = ProjMtx * vec4(Position.xy,0,1);\n"
         "}\n";
 
+    // When TextureSdf is set, the alpha channel holds a distance field: we threshold it at 0.5 with a one pixel wide anti-aliased edge.
+    // (GL ES 2.0 without derivatives uses TextureSdfWidth, computed on the CPU in ImGui_ImplOpenGL3_SetupRenderState(), instead of fwidth())
     const GLchar* fragment_shader_glsl_120 =
         "#ifdef GL_ES\n"
+        "#ifdef GL_OES_standard_derivatives\n"
+        "#extension GL_OES_standard_derivatives : enable\n"
+        "#else\n"
+        "uniform mediump float TextureSdfWidth;\n"
+        "#define fwidth(x) TextureSdfWidth\n"
+        "#endif\n"
         "    precision mediump float;\n"
         "#endif\n"
         "uniform sampler2D Texture;\n"
+        "uniform bool TextureSdf;\n"
         "varying vec2 Frag_UV;\n"
         "varying vec4 Frag_Color;\n"
         "void main()\n"
         "{\n"
-        "    gl_FragColor = Frag_Color * texture2D(Texture, Frag_UV.st);\n"
+        "    vec4 tex_color = texture2D(Texture, Frag_UV.st);\n"
+        "    if (TextureSdf)\n"
+        "        tex_color.a = clamp((tex_color.a - 0.5) / max(fwidth(tex_color.a), 0.0001) + 0.5, 0.0, 1.0);\n"
+        "    gl_FragColor = Frag_Color * tex_color;\n"
         "}\n";
 
     const GLchar* fragment_shader_glsl_130 =
         "uniform sampler2D Texture;\n"
+        "uniform bool TextureSdf;\n"
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
         "out vec4 Out_Color;\n"
         "void main()\n"
         "{\n"
-        "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "    vec4 tex_color = texture(Texture, Frag_UV.st);\n"
+        "    if (TextureSdf)\n"
+        "        tex_color.a = clamp((tex_color.a - 0.5) / max(fwidth(tex_color.a), 0.0001) + 0.5, 0.0, 1.0);\n"
+        "    Out_Color = Frag_Color * tex_color;\n"
         "}\n";
 
     const GLchar* fragment_shader_glsl_300_es =
         "precision mediump float;\n"
         "uniform sampler2D Texture;\n"
+        "uniform bool TextureSdf;\n"
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
         "layout (location = 0) out vec4 Out_Color;\n"
         "void main()\n"
         "{\n"
-        "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "    vec4 tex_color = texture(Texture, Frag_UV.st);\n"
+        "    if (TextureSdf)\n"
+        "        tex_color.a = clamp((tex_color.a - 0.5) / max(fwidth(tex_color.a), 0.0001) + 0.5, 0.0, 1.0);\n"
+        "    Out_Color = Frag_Color * tex_color;\n"
         "}\n";
 
     const GLchar* fragment_shader_glsl_410_core =
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
         "uniform sampler2D Texture;\n"
+        "uniform bool TextureSdf;\n"
         "layout (location = 0) out vec4 Out_Color;\n"
         "void main()\n"
         "{\n"
-        "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "    vec4 tex_color = texture(Texture, Frag_UV.st);\n"
+        "    if (TextureSdf)\n"
+        "        tex_color.a = clamp((tex_color.a - 0.5) / max(fwidth(tex_color.a), 0.0001) + 0.5, 0.0, 1.0);\n"
+        "    Out_Color = Frag_Color * tex_color;\n"
         "}\n";
 
     // Select shaders matching our GLSL versions
@@ -618,6 +768,8 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
     CheckProgram(g_ShaderHandle, "shader program");
 
     g_AttribLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
+    g_AttribLocationTexSdf = glGetUniformLocation(g_ShaderHandle, "TextureSdf");
+    g_AttribLocationTexSdfWidth = glGetUniformLocation(g_ShaderHandle, "TextureSdfWidth"); // -1 unless GL ES 2.0 without GL_OES_standard_derivatives
     g_AttribLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMtx");
     g_AttribLocationVtxPos = glGetAttribLocation(g_ShaderHandle, "Position");
     g_AttribLocationVtxUV = glGetAttribLocation(g_ShaderHandle, "UV");
@@ -3,6 +3,7 @@
 
 // Implemented features:
 //  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bits indices.
+//  [X] Renderer: Single channel font texture (1 byte per texel). Block-compressed font texture (ImFontAtlasFlags_CompressBC4) when the device supports BC formats.
 // Missing features:
 //  [ ] Renderer: User texture binding. Changes of ImTextureID aren't supported by this binding! See https://github.com/ocornut/imgui/pull/914
 
@@ -22,6 +23,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2019-10-21: Vulkan: Upload the font texture as VK_FORMAT_R8_UNORM swizzled to (1,1,1,alpha) instead of RGBA32. Upload it as VK_FORMAT_BC4_UNORM_BLOCK with ImFontAtlasFlags_CompressBC4 when supported by the device.
 //  2019-08-01: Vulkan: Added support for specifying multisample count. Set ImGui_ImplVulkan_InitInfo::MSAASamples to one of the VkSampleCountFlagBits values to use, default is non-multisampled as before.
 //  2019-05-29: Vulkan: Added support for large mesh (64K+ vertices), enable ImGuiBackendFlags_RendererHasVtxOffset flag.
 //  2019-04-30: Vulkan: Added support for special ImDrawCallback_ResetRenderState callback to reset render state.
@@ -437,10 +439,31 @@ bool ImGui_ImplVulkan_CreateFontsTexture(VkCommandBuffer command_buffer)
     ImGui_ImplVulkan_InitInfo* v = &g_VulkanInitInfo;
     ImGuiIO& io = ImGui::GetIO();
 
+    // Select texture format
+    // We upload the Alpha8 data in a single channel texture (or its BC4 encoding if requested and supported), and use the image view to swizzle it to (1,1,1,alpha).
+    VkFormat format = VK_FORMAT_R8_UNORM;
+    if ((io.Fonts->Flags & ImFontAtlasFlags_CompressBC4) && !(io.Fonts->Flags & ImFontAtlasFlags_DynamicGlyphs))
+    {
+        VkFormatProperties format_props;
+        vkGetPhysicalDeviceFormatProperties(v->PhysicalDevice, VK_FORMAT_BC4_UNORM_BLOCK, &format_props);
+        if (format_props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)
+            format = VK_FORMAT_BC4_UNORM_BLOCK;
+    }
+
     unsigned char* pixels;
     int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-    size_t upload_size = width*height*4*sizeof(char);
+    size_t upload_size;
+    if (format == VK_FORMAT_BC4_UNORM_BLOCK)
+    {
+        int size;
+        io.Fonts->GetTexDataAsBC4(&pixels, &width, &height, &size);
+        upload_size = (size_t)size;
+    }
+    else
+    {
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        upload_size = width*height*sizeof(char);
+    }
 
     VkResult err;
 
@@ -449,7 +472,7 @@ bool ImGui_ImplVulkan_CreateFontsTexture(VkCommandBuffer command_buffer)
         VkImageCreateInfo info = {};
         info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         info.imageType = VK_IMAGE_TYPE_2D;
-        info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        info.format = format;
         info.extent.width = width;
         info.extent.height = height;
         info.extent.depth = 1;
@@ -480,7 +503,11 @@ bool ImGui_ImplVulkan_CreateFontsTexture(VkCommandBuffer command_buffer)
         info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         info.image = g_FontImage;
         info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        info.format = format;
+        info.components.r = VK_COMPONENT_SWIZZLE_ONE;
+        info.components.g = VK_COMPONENT_SWIZZLE_ONE;
+        info.components.b = VK_COMPONENT_SWIZZLE_ONE;
+        info.components.a = VK_COMPONENT_SWIZZLE_R;
         info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         info.subresourceRange.levelCount = 1;
         info.subresourceRange.layerCount = 1;
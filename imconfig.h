@@ -38,13 +38,27 @@
 //#define IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS             // Don't implement ImFormatString/ImFormatStringV so you can implement them yourself if you don't want to link with vsnprintf.
 //#define IMGUI_DISABLE_MATH_FUNCTIONS                      // Don't implement ImFabs/ImSqrt/ImPow/ImFmod/ImCos/ImSin/ImAcos/ImAtan2 wrapper so you can implement them yourself. Declare your prototypes in imconfig.h.
 //#define IMGUI_DISABLE_DEFAULT_ALLOCATORS                  // Don't implement default allocators calling malloc()/free() to avoid linking with them. You will need to call ImGui::SetAllocatorFunctions().
+//#define IMGUI_DISABLE_SSE                                 // Don't use SSE2 intrinsics (used by the text functions when available).
+//#define IMGUI_DISABLE_NEON                                // Don't use NEON intrinsics (used by the text functions when available).
+
+//---- Use a C++11 thread_local for the current context pointer (GImGui), so N threads can each use their own context in parallel.
+// A ImFontAtlas shared between those contexts needs to be built, and its 'Locked' field set to true, before starting the threads.
+//#define IMGUI_ENABLE_THREAD_LOCAL_CONTEXT
 
 //---- Include imgui_user.h at the end of imgui.h as a convenience
 //#define IMGUI_INCLUDE_IMGUI_USER_H
 
+//---- Use 32-bit for ImWchar (default is 16-bit) to support Unicode planes 1-16 (e.g. emojis, supplementary CJK ideographs).
+// Glyph lookup tables are paged so this only costs memory for the blocks of code points your fonts actually use.
+//#define IMGUI_USE_WCHAR32
+
 //---- Pack colors to BGRA8 instead of RGBA8 (to avoid converting from one to another)
 //#define IMGUI_USE_BGRA_PACKED_COLOR
 
+//---- Format numbers for the most common formats used by widgets and Text() ("%d", "%u", "%.3f", "%g"...) without calling vsnprintf().
+// Output is identical except numbers always use a '.' decimal point regardless of the C locale (which widgets also accept when parsing). Other formats still go through vsnprintf().
+//#define IMGUI_USE_FAST_NUMBER_FORMAT
+
 //---- Avoid multiple STB libraries implementations, or redefine path/filenames to prioritize another version
 // By default the embedded implementations are declared static and not available outside of imgui cpp files.
 //#define IMGUI_STB_TRUETYPE_FILENAME   "my_folder/stb_truetype.h"
@@ -369,6 +369,7 @@ CODE
  When you are not sure about a old symbol or function name, try using the Search/Find function of your IDE to look for comments or references in all imgui files.
  You can read releases logs https://github.com/ocornut/imgui/releases for more details.
 
+ - 2019/10/18 (1.74) - ImFont::IndexAdvanceX[]/IndexLookup[] are now paged and can't be indexed by codepoint anymore. Use ImFont::GetCharAdvance(), FindGlyph() or GetIndexSlot().
  - 2019/07/15 (1.72) - removed TreeAdvanceToLabelPos() which is rarely used and only does SetCursorPosX(GetCursorPosX() + GetTreeNodeToLabelSpacing()). Kept redirection function (will obsolete).
  - 2019/07/12 (1.72) - renamed ImFontAtlas::CustomRect to ImFontAtlasCustomRect. Kept redirection typedef (will obsolete).
  - 2019/06/14 (1.72) - removed redirecting functions/enums names that were marked obsolete in 1.51 (June 2017): ImGuiCol_Column*, ImGuiSetCond_*, IsItemHoveredRect(), IsPosHoveringAnyWindow(), IsMouseHoveringAnyWindow(), IsMouseHoveringWindow(), IMGUI_ONCE_UPON_A_FRAME. Grep this log for details and new names.
@@ -980,6 +981,22 @@ CODE
 #include <stdint.h>     // intptr_t
 #endif
 
+// Windows API for UTF-8 file names and atomic file replacement (ImFileOpen(), ImFileRename(), ImFileRemove())
+// With IMGUI_DISABLE_WIN32_FUNCTIONS they use the narrow C functions instead: fopen(), rename() (which fails if the destination exists), remove().
+#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS) && !defined(_WINDOWS_)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef __MINGW32__
+#include <Windows.h>    // MultiByteToWideChar, MoveFileExW
+#else
+#include <windows.h>
+#endif
+#endif
+
 // Debug options
 #define IMGUI_DEBUG_NAV_SCORING     0   // Display navigation scoring preview when hovering items. Display last moving direction matches when holding CTRL
 #define IMGUI_DEBUG_NAV_RECTS       0   // Display the reference navigation rectangle for each window
@@ -1030,6 +1047,9 @@ static const float WINDOWS_RESIZE_FROM_EDGES_HALF_THICKNESS = 4.0f;     // Exten
 static const float WINDOWS_RESIZE_FROM_EDGES_FEEDBACK_TIMER = 0.04f;    // Reduce visual noise by only highlighting the border after a certain time.
 static const float WINDOWS_MOUSE_WHEEL_SCROLL_LOCK_TIMER    = 2.00f;    // Lock scrolled window (so it doesn't pick child windows that are scrolling through) for a certaint time, unless mouse moved.
 
+// Memory budget (when io.ConfigMemoryCompactBudget > 0)
+static const float GC_MEMORY_BUDGET_CHECK_INTERVAL          = 1.00f;    // Time between two checks of the memory budget, as GcCompactToMemoryBudget() walks every window.
+
 //-------------------------------------------------------------------------
 // [SECTION] FORWARD DECLARATIONS
 //-------------------------------------------------------------------------
@@ -1049,11 +1069,13 @@ static ImRect           GetViewportRect();
 static void*            SettingsHandlerWindow_ReadOpen(ImGuiContext*, ImGuiSettingsHandler*, const char* name);
 static void             SettingsHandlerWindow_ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry, const char* line);
 static void             SettingsHandlerWindow_WriteAll(ImGuiContext* imgui_ctx, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf);
+static void             SettingsHandlerWindow_ReadDeferredLines(ImGuiContext* imgui_ctx, ImGuiWindowSettings* settings);
 
 // Platform Dependents default implementation for IO functions
 static const char*      GetClipboardTextFn_DefaultImpl(void* user_data);
 static void             SetClipboardTextFn_DefaultImpl(void* user_data, const char* text);
 static void             ImeSetInputScreenPosFn_DefaultImpl(int x, int y);
+static void             WriteIniFileFn_DefaultImpl(void* user_data, const char* filename, const char* data, size_t data_size);
 
 namespace ImGui
 {
@@ -1095,16 +1117,23 @@ static void             RenderWindowTitleBarContents(ImGuiWindow* window, const
 //    In your debugger, add GImGui to your watch window and notice how its value changes depending on which location you are currently stepping into.
 // 2) Important: Dear ImGui functions are not thread-safe because of this pointer.
 //    If you want thread-safety to allow N threads to access N different contexts, you can:
-//    - Change this variable to use thread local storage so each thread can refer to a different context, in imconfig.h:
+//    - Change this variable to use thread local storage so each thread can refer to a different context, by enabling
+//      '#define IMGUI_ENABLE_THREAD_LOCAL_CONTEXT' in imconfig.h (requires C++11 'thread_local'). Or with your own variable, in imconfig.h:
 //          struct ImGuiContext;
 //          extern thread_local ImGuiContext* MyImGuiTLS;
 //          #define GImGui MyImGuiTLS
 //      And then define MyImGuiTLS in one of your cpp file. Note that thread_local is a C++11 keyword, earlier C++ uses compiler-specific keyword.
+//      Contexts running on different threads may share a ImFontAtlas: build it and set its 'Locked' field to true before starting the threads,
+//      so NewFrame()/EndFrame() never write to it. Other global state (allocator functions) is only read and may be set up once at startup.
 //    - Future development aim to make this context pointer explicit to all calls. Also read https://github.com/ocornut/imgui/issues/586
 //    - If you need a finite number of contexts, you may compile and use multiple instances of the ImGui code from different namespace.
 #ifndef GImGui
+#ifdef IMGUI_ENABLE_THREAD_LOCAL_CONTEXT
+thread_local ImGuiContext* GImGui = NULL;
+#else
 ImGuiContext*   GImGui = NULL;
 #endif
+#endif
 
 // Memory Allocator functions. Use SetAllocatorFunctions() to change them.
 // If you use DLL hotreloading you might need to call SetAllocatorFunctions() after reloading code from this file.
@@ -1227,9 +1256,11 @@ ImGuiIO::ImGuiIO()
     ConfigMacOSXBehaviors = false;
 #endif
     ConfigInputTextCursorBlink = true;
+    ConfigInputTextUndoBudget = 1024 * 1024;
     ConfigWindowsResizeFromEdges = true;
     ConfigWindowsMoveFromTitleBarOnly = false;
     ConfigWindowsMemoryCompactTimer = 60.0f;
+    ConfigMemoryCompactBudget = 0;
 
     // Platform Functions
     BackendPlatformName = BackendRendererName = NULL;
@@ -1237,6 +1268,8 @@ ImGuiIO::ImGuiIO()
     GetClipboardTextFn = GetClipboardTextFn_DefaultImpl;   // Platform dependent default implementations
     SetClipboardTextFn = SetClipboardTextFn_DefaultImpl;
     ClipboardUserData = NULL;
+    WriteIniFileFn = WriteIniFileFn_DefaultImpl;
+    IniUserData = NULL;
     ImeSetInputScreenPosFn = ImeSetInputScreenPosFn_DefaultImpl;
     ImeWindowHandle = NULL;
 
@@ -1258,8 +1291,34 @@ ImGuiIO::ImGuiIO()
 // - on Windows you can get those using ToAscii+keyboard state, or via the WM_CHAR message
 void ImGuiIO::AddInputCharacter(unsigned int c)
 {
-    if (c > 0 && c < 0x10000)
-        InputQueueCharacters.push_back((ImWchar)c);
+    if (c > 0)
+        InputQueueCharacters.push_back(c <= IM_UNICODE_CODEPOINT_MAX ? (ImWchar)c : IM_UNICODE_CODEPOINT_INVALID);
+}
+
+// UTF16 strings use surrogate pairs to encode code points >= 0x10000, so
+// we should save the high surrogate.
+void ImGuiIO::AddInputCharacterUTF16(ImWchar16 c)
+{
+    if ((c & 0xFC00) == 0xD800) // High surrogate, must save
+    {
+        if (InputQueueSurrogate != 0)
+            InputQueueCharacters.push_back(IM_UNICODE_CODEPOINT_INVALID);
+        InputQueueSurrogate = c;
+        return;
+    }
+
+    ImWchar cp = c;
+    if (InputQueueSurrogate != 0)
+    {
+        if ((c & 0xFC00) != 0xDC00) // Invalid low surrogate
+            InputQueueCharacters.push_back(IM_UNICODE_CODEPOINT_INVALID);
+        else if (IM_UNICODE_CODEPOINT_MAX == (0xFFFF)) // Code point won't fit in ImWchar (extra parenthesis avoid -Wunreachable-code with Clang)
+            cp = IM_UNICODE_CODEPOINT_INVALID;
+        else
+            cp = (ImWchar)(((InputQueueSurrogate - 0xD800) << 10) + (c - 0xDC00) + 0x10000);
+        InputQueueSurrogate = 0;
+    }
+    InputQueueCharacters.push_back(cp);
 }
 
 void ImGuiIO::AddInputCharactersUTF8(const char* utf8_chars)
@@ -1268,7 +1327,7 @@ void ImGuiIO::AddInputCharactersUTF8(const char* utf8_chars)
     {
         unsigned int c = 0;
         utf8_chars += ImTextCharFromUtf8(&c, utf8_chars, NULL);
-        if (c > 0 && c < 0x10000)
+        if (c > 0)
             InputQueueCharacters.push_back((ImWchar)c);
     }
 }
@@ -1425,6 +1484,58 @@ const char* ImStristr(const char* haystack, const char* haystack_end, const char
     return NULL;
 }
 
+static inline bool ImStrEqualsLower(const char* str, const char* str_lower, int count)
+{
+    for (int n = 0; n < count; n++)
+        if (ImCharToLowerA(str[n]) != str_lower[n])
+            return false;
+    return true;
+}
+
+// Case-insensitive search for ASCII letters, with a needle already in lowercase (e.g. preprocessed once by ImGuiTextFilter::Build()).
+// Occurrences of the first character of the needle are looked for 16 bytes at a time when SSE2/NEON is available.
+const char* ImStristrLower(const char* haystack, const char* haystack_end, const char* needle_lower, const char* needle_lower_end)
+{
+    const int needle_len = (int)(needle_lower_end - needle_lower);
+    if (needle_len == 0)
+        return haystack;
+    if (haystack_end - haystack < needle_len)
+        return NULL;
+    const char* haystack_last = haystack_end - needle_len; // Last position the needle can start at
+    const char c0 = needle_lower[0];
+    const char c0_upper = (c0 >= 'a' && c0 <= 'z') ? (char)(c0 - 'a' + 'A') : c0;
+#if defined(IMGUI_ENABLE_SSE)
+    const __m128i v_c0 = _mm_set1_epi8(c0);
+    const __m128i v_c0_upper = _mm_set1_epi8(c0_upper);
+    while (haystack_last - haystack >= 15)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)haystack);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, v_c0), _mm_cmpeq_epi8(v, v_c0_upper)));
+        for (const char* p = haystack; mask != 0; p++, mask >>= 1)
+            if ((mask & 1) && ImStrEqualsLower(p + 1, needle_lower + 1, needle_len - 1))
+                return p;
+        haystack += 16;
+    }
+#elif defined(IMGUI_ENABLE_NEON)
+    const uint8x16_t v_c0 = vdupq_n_u8((uint8_t)c0);
+    const uint8x16_t v_c0_upper = vdupq_n_u8((uint8_t)c0_upper);
+    while (haystack_last - haystack >= 15)
+    {
+        const uint8x16_t v = vld1q_u8((const uint8_t*)(const void*)haystack);
+        const uint64x2_t mask = vreinterpretq_u64_u8(vorrq_u8(vceqq_u8(v, v_c0), vceqq_u8(v, v_c0_upper)));
+        if ((vgetq_lane_u64(mask, 0) | vgetq_lane_u64(mask, 1)) != 0)
+            for (const char* p = haystack; p < haystack + 16; p++)
+                if ((*p == c0 || *p == c0_upper) && ImStrEqualsLower(p + 1, needle_lower + 1, needle_len - 1))
+                    return p;
+        haystack += 16;
+    }
+#endif
+    for (; haystack <= haystack_last; haystack++)
+        if ((*haystack == c0 || *haystack == c0_upper) && ImStrEqualsLower(haystack + 1, needle_lower + 1, needle_len - 1))
+            return haystack;
+    return NULL;
+}
+
 // Trim str by offsetting contents when there's leading data + writing a \0 at the trailing position. We use this in situation where the cost is negligible.
 void ImStrTrimBlanks(char* buf)
 {
@@ -1456,16 +1567,13 @@ void ImStrTrimBlanks(char* buf)
 #define vsnprintf _vsnprintf
 #endif
 
-int ImFormatString(char* buf, size_t buf_size, const char* fmt, ...)
+static int ImFormatStringVSlow(char* buf, size_t buf_size, const char* fmt, va_list args)
 {
-    va_list args;
-    va_start(args, fmt);
 #ifdef IMGUI_USE_STB_SPRINTF
     int w = stbsp_vsnprintf(buf, (int)buf_size, fmt, args);
 #else
     int w = vsnprintf(buf, buf_size, fmt, args);
 #endif
-    va_end(args);
     if (buf == NULL)
         return w;
     if (w == -1 || w >= (int)buf_size)
@@ -1474,20 +1582,223 @@ int ImFormatString(char* buf, size_t buf_size, const char* fmt, ...)
     return w;
 }
 
-int ImFormatStringV(char* buf, size_t buf_size, const char* fmt, va_list args)
+#ifdef IMGUI_USE_FAST_NUMBER_FORMAT
+static int ImFormatStringSlow(char* buf, size_t buf_size, const char* fmt, ...)
 {
-#ifdef IMGUI_USE_STB_SPRINTF
-    int w = stbsp_vsnprintf(buf, (int)buf_size, fmt, args);
-#else
-    int w = vsnprintf(buf, buf_size, fmt, args);
-#endif
+    va_list args;
+    va_start(args, fmt);
+    int w = ImFormatStringVSlow(buf, buf_size, fmt, args);
+    va_end(args);
+    return w;
+}
+
+// Write 'v' with 'frac_digits' digits after the decimal point, as "%.*f" would. Return NULL when the rounding of the exact value is uncertain
+// (close to a tie between two outputs, which vsnprintf() resolves using the exact decimal expansion of 'v'), or for large values and NaN.
+// 'out_n' receives the rounded value multiplied by 10^frac_digits.
+static const ImU64 GPow10U64[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL };
+static const double GPow10D[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+static bool ImFormatFixedRound(double v_abs, int frac_digits, ImU64* out_n)
+{
+    if (frac_digits < 0 || frac_digits >= IM_ARRAYSIZE(GPow10D))
+        return false;
+    const double scaled = v_abs * GPow10D[frac_digits];    // Multiplication is correctly rounded: off by at most half an ulp
+    if (!(scaled < 4503599627370496.0))                     // 2^52, also false for NaN and +inf
+        return false;
+    const double scaled_floor = floor(scaled);
+    const double frac = scaled - scaled_floor;              // Exact
+    const double tie_distance = (frac > 0.5) ? frac - 0.5 : 0.5 - frac;
+    if (tie_distance <= scaled * 2.3e-16)                   // Within 1 ulp of a tie
+        return false;
+    *out_n = (ImU64)scaled_floor + (frac > 0.5 ? 1 : 0);
+    return true;
+}
+
+static char* ImFormatWriteFixed(char* p, bool negative, ImU64 n, int frac_digits, bool trim_zeros)
+{
+    char digits[24];
+    char* d = digits + IM_ARRAYSIZE(digits);
+    int count = 0;
+    do { *--d = (char)('0' + (int)(n % 10)); n /= 10; count++; } while (n != 0 || count <= frac_digits);
+    if (negative)
+        *p++ = '-';
+    const int int_digits = count - frac_digits;
+    memcpy(p, d, (size_t)int_digits);
+    p += int_digits;
+    d += int_digits;
+    if (trim_zeros)
+        while (frac_digits > 0 && d[frac_digits - 1] == '0')
+            frac_digits--;
+    if (frac_digits > 0)
+    {
+        *p++ = '.';
+        memcpy(p, d, (size_t)frac_digits);
+        p += frac_digits;
+    }
+    return p;
+}
+
+// Write 'v' as "%.*g" would, for the cases not using an exponent.
+static char* ImFormatWriteGeneral(char* p, double v, bool negative, int precision)
+{
+    const double v_abs = negative ? -v : v;
+    if (v_abs == 0.0)
+        return ImFormatWriteFixed(p, negative, 0, 0, true);
+    if (!(v_abs >= 1e-4 && v_abs < GPow10D[precision]))
+        return NULL;
+
+    // The exponent is the one after rounding to 'precision' significant digits, which log10() may be off by one for
+    int exponent = (int)floor(log10(v_abs));
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        const int frac_digits = precision - 1 - exponent;
+        ImU64 n;
+        if (exponent < -4 || frac_digits < 0 || !ImFormatFixedRound(v_abs, frac_digits, &n))
+            return NULL;
+        if (n >= GPow10U64[precision])
+            exponent++;
+        else if (n < GPow10U64[precision - 1])
+            exponent--;
+        else
+            return ImFormatWriteFixed(p, negative, n, frac_digits, true);
+    }
+    return NULL;
+}
+
+// Fast path for the most common formats, e.g. widgets formatting a single number: a single "%d", "%i", "%u" (with optional 'l', 'll', 'I64' size),
+// "%f" or "%g" (with optional precision) specifier with any text around it. Other formats (flags, width, multiple arguments...) return -1 without
+// reading 'args', and edge cases of number formatting are passed on to vsnprintf(). Numbers are always written with a '.' decimal point.
+static int ImFormatStringVFast(char* buf, size_t buf_size, const char* fmt, va_list args)
+{
+    // Parse format
+    const char* spec_begin = NULL;
+    const char* spec_end = NULL;
+    int precision = -1;
+    int size = 0; // 0: int, 1: long, 2: long long
+    char type = 0;
+    for (const char* p = fmt; *p; p++)
+    {
+        if (*p != '%')
+            continue;
+        if (p[1] == '%')
+        {
+            p++;
+            continue;
+        }
+        if (spec_begin != NULL)
+            return -1; // More than one argument
+        spec_begin = p++;
+        if (*p == '.')
+        {
+            precision = 0;
+            for (p++; *p >= '0' && *p <= '9' && precision < 100; p++)
+                precision = precision * 10 + (*p - '0');
+        }
+        if (p[0] == 'l' && p[1] == 'l')                         { size = 2; p += 2; }
+        else if (p[0] == 'l')                                   { size = 1; p += 1; }
+        else if (p[0] == 'I' && p[1] == '6' && p[2] == '4')     { size = 2; p += 3; }
+        type = *p;
+        if (type == 'd' || type == 'i' || type == 'u')
+        {
+            if (precision >= 0)
+                return -1;
+        }
+        else if (type == 'f' || type == 'F' || type == 'g' || type == 'G')
+        {
+            if (size == 2)
+                return -1;
+        }
+        else
+        {
+            return -1;
+        }
+        spec_end = p + 1;
+    }
+    if (spec_begin == NULL)
+        return -1;
+
+    // Format number
+    char num_buf[48];
+    char* num_end = NULL;
+    if (type == 'd' || type == 'i' || type == 'u')
+    {
+        ImU64 n;
+        bool negative = false;
+        if (type == 'u')
+            n = (size == 2) ? (ImU64)va_arg(args, unsigned long long) : (size == 1) ? (ImU64)va_arg(args, unsigned long) : (ImU64)va_arg(args, unsigned int);
+        else
+        {
+            const ImS64 s = (size == 2) ? (ImS64)va_arg(args, long long) : (size == 1) ? (ImS64)va_arg(args, long) : (ImS64)va_arg(args, int);
+            negative = (s < 0);
+            n = negative ? (ImU64)0 - (ImU64)s : (ImU64)s;
+        }
+        num_end = ImFormatWriteFixed(num_buf, negative, n, 0, false);
+    }
+    else
+    {
+        const double v = va_arg(args, double);
+        ImU64 v_bits;
+        memcpy(&v_bits, &v, sizeof(v));
+        const bool negative = (v_bits >> 63) != 0; // Also for -0.0, printed as "-0.000" like vsnprintf() does
+        if (type == 'f' || type == 'F')
+        {
+            ImU64 n;
+            if (precision < 0)
+                precision = 6;
+            if (ImFormatFixedRound(negative ? -v : v, precision, &n))
+                num_end = ImFormatWriteFixed(num_buf, negative, n, precision, false);
+        }
+        else
+        {
+            if (precision < 0)
+                precision = 6;
+            else if (precision == 0)
+                precision = 1;
+            if (precision < IM_ARRAYSIZE(GPow10D) - 4)
+                num_end = ImFormatWriteGeneral(num_buf, v, negative, precision);
+        }
+        if (num_end == NULL)
+            return ImFormatStringSlow(buf, buf_size, fmt, v);
+    }
+
+    // Assemble text before the number, the number and text after it, unescaping "%%"
+    size_t w = 0;
+    const char* segments[3][2] = { { fmt, spec_begin }, { num_buf, num_end }, { spec_end, spec_end + strlen(spec_end) } };
+    for (int segment_n = 0; segment_n < 3; segment_n++)
+        for (const char* s = segments[segment_n][0]; s < segments[segment_n][1]; s++)
+        {
+            if (segment_n != 1 && s[0] == '%')
+                s++;
+            if (buf != NULL && w + 1 < buf_size)
+                buf[w] = *s;
+            w++;
+        }
     if (buf == NULL)
-        return w;
-    if (w == -1 || w >= (int)buf_size)
-        w = (int)buf_size - 1;
+        return (int)w;
+    if (w >= buf_size)
+        w = buf_size - 1;
     buf[w] = 0;
+    return (int)w;
+}
+#endif // #ifdef IMGUI_USE_FAST_NUMBER_FORMAT
+
+int ImFormatString(char* buf, size_t buf_size, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int w = ImFormatStringV(buf, buf_size, fmt, args);
+    va_end(args);
     return w;
 }
+
+int ImFormatStringV(char* buf, size_t buf_size, const char* fmt, va_list args)
+{
+#ifdef IMGUI_USE_FAST_NUMBER_FORMAT
+    int w = ImFormatStringVFast(buf, buf_size, fmt, args);
+    if (w != -1)
+        return w;
+#endif
+    return ImFormatStringVSlow(buf, buf_size, fmt, args);
+}
 #endif // #ifdef IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS
 
 // CRC32 needs a 1KB lookup table (not cache friendly)
@@ -1560,22 +1871,62 @@ ImU32 ImHashStr(const char* data_p, size_t data_size, ImU32 seed)
     return ~crc;
 }
 
+#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS)
+// Convert a UTF-8 string to UTF-16 for the wide Windows file functions.
+// Don't use ImTextStrFromUtf8(): ImWchar may be 32-bit (IMGUI_USE_WCHAR32) and it doesn't encode surrogate pairs.
+static bool ImFileWidenPath(const char* utf8, ImVector<wchar_t>* out_buf)
+{
+    const int wsize = ::MultiByteToWideChar(CP_UTF8, 0, utf8, -1, NULL, 0);
+    if (wsize <= 0)
+        return false;
+    out_buf->resize(wsize);
+    return ::MultiByteToWideChar(CP_UTF8, 0, utf8, -1, out_buf->Data, wsize) == wsize;
+}
+#endif
+
 FILE* ImFileOpen(const char* filename, const char* mode)
 {
-#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(__GNUC__)
-    // We need a fopen() wrapper because MSVC/Windows fopen doesn't handle UTF-8 filenames. Converting both strings from UTF-8 to wchar format (using a single allocation, because we can)
-    const int filename_wsize = ImTextCountCharsFromUtf8(filename, NULL) + 1;
-    const int mode_wsize = ImTextCountCharsFromUtf8(mode, NULL) + 1;
-    ImVector<ImWchar> buf;
-    buf.resize(filename_wsize + mode_wsize);
-    ImTextStrFromUtf8(&buf[0], filename_wsize, filename, NULL);
-    ImTextStrFromUtf8(&buf[filename_wsize], mode_wsize, mode, NULL);
-    return _wfopen((wchar_t*)&buf[0], (wchar_t*)&buf[filename_wsize]);
+#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS)
+    // We need a fopen() wrapper because Windows fopen() (MSVC and MinGW runtimes) doesn't handle UTF-8 filenames. Converting both strings from UTF-8 to UTF-16.
+    ImVector<wchar_t> filename_w, mode_w;
+    if (!ImFileWidenPath(filename, &filename_w) || !ImFileWidenPath(mode, &mode_w))
+        return NULL;
+    return _wfopen(filename_w.Data, mode_w.Data);
 #else
     return fopen(filename, mode);
 #endif
 }
 
+bool ImFileRename(const char* src_filename, const char* dst_filename)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS)
+    // Windows rename() fails when the destination exists. MoveFileExW() replaces it in a single operation instead, so there is no window
+    // where neither file exists (e.g. if we crash, or the rename fails after removing the destination).
+    ImVector<wchar_t> src_w, dst_w;
+    if (!ImFileWidenPath(src_filename, &src_w) || !ImFileWidenPath(dst_filename, &dst_w))
+        return false;
+    return ::MoveFileExW(src_w.Data, dst_w.Data, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+#ifdef _WIN32
+    remove(dst_filename); // rename() fails when the destination exists
+#endif
+    return rename(src_filename, dst_filename) == 0;
+#endif
+}
+
+bool ImFileRemove(const char* filename)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS)
+    // Same as ImFileOpen(): Windows remove() doesn't handle UTF-8 filenames.
+    ImVector<wchar_t> filename_w;
+    if (!ImFileWidenPath(filename, &filename_w))
+        return false;
+    return ::DeleteFileW(filename_w.Data) != 0;
+#else
+    return remove(filename) == 0;
+#endif
+}
+
 // Load file content into memory
 // Memory allocated with IM_ALLOC(), must be freed by user using IM_FREE() == ImGui::MemFree()
 void* ImFileLoadToMemory(const char* filename, const char* file_open_mode, size_t* out_file_size, int padding_bytes)
@@ -1676,6 +2027,8 @@ int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char*
         c += (*str++ & 0x3f);
         // utf-8 encodings of values used in surrogate pairs are invalid
         if ((c & 0xFFFFF800) == 0xD800) return 4;
+        // If code point doesn't fit in ImWchar, use the replacement character U+FFFD instead
+        if (c > IM_UNICODE_CODEPOINT_MAX) c = IM_UNICODE_CODEPOINT_INVALID;
         *out_char = c;
         return 4;
     }
@@ -1683,18 +2036,56 @@ int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char*
     return 0;
 }
 
+// Skip over a run of ASCII characters, which don't need any decoding. Test 16 bytes at a time when SSE2/NEON is available.
+// With min_char = 1 this skips characters that can be copied as is, with min_char = 0x20 it also stops on control characters.
+const char* ImTextFindNonAscii(const char* in_text, const char* in_text_end, char min_char)
+{
+    IM_ASSERT(min_char >= 0);
+#if defined(IMGUI_ENABLE_SSE)
+    const __m128i threshold = _mm_set1_epi8((char)(min_char - 1));
+    while (in_text_end - in_text >= 16)
+    {
+        // Signed comparison: bytes >= 0x80 are negative so they fail the test along with bytes < min_char
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)in_text);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(v, threshold)) != 0xFFFF)
+            break;
+        in_text += 16;
+    }
+#elif defined(IMGUI_ENABLE_NEON)
+    const int8x16_t threshold = vdupq_n_s8((int8_t)(min_char - 1));
+    while (in_text_end - in_text >= 16)
+    {
+        const uint64x2_t mask = vreinterpretq_u64_u8(vcgtq_s8(vld1q_s8((const int8_t*)(const void*)in_text), threshold));
+        if ((vgetq_lane_u64(mask, 0) & vgetq_lane_u64(mask, 1)) != ~(ImU64)0)
+            break;
+        in_text += 16;
+    }
+#endif
+    while (in_text < in_text_end && (unsigned char)*in_text >= (unsigned char)min_char && (unsigned char)*in_text < 0x80)
+        in_text++;
+    return in_text;
+}
+
 int ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char* in_text, const char* in_text_end, const char** in_text_remaining)
 {
     ImWchar* buf_out = buf;
     ImWchar* buf_end = buf + buf_size;
     while (buf_out < buf_end-1 && (!in_text_end || in_text < in_text_end) && *in_text)
     {
+        // Fast path: copy runs of ASCII characters without decoding them (we need a known end to read ahead)
+        if (in_text_end && !(*in_text & 0x80))
+        {
+            const int run_max = ImMin((int)(in_text_end - in_text), (int)(buf_end - 1 - buf_out));
+            for (const char* run_end = ImTextFindNonAscii(in_text, in_text + run_max, 1); in_text < run_end; )
+                *buf_out++ = (ImWchar)*in_text++;
+            continue;
+        }
+
         unsigned int c;
         in_text += ImTextCharFromUtf8(&c, in_text, in_text_end);
         if (c == 0)
             break;
-        if (c < 0x10000)    // FIXME: Losing characters that don't fit in 2 bytes
-            *buf_out++ = (ImWchar)c;
+        *buf_out++ = (ImWchar)c;
     }
     *buf_out = 0;
     if (in_text_remaining)
@@ -1707,12 +2098,19 @@ int ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end)
     int char_count = 0;
     while ((!in_text_end || in_text < in_text_end) && *in_text)
     {
+        if (in_text_end && !(*in_text & 0x80))
+        {
+            const char* run_end = ImTextFindNonAscii(in_text, in_text_end, 1);
+            char_count += (int)(run_end - in_text);
+            in_text = run_end;
+            continue;
+        }
+
         unsigned int c;
         in_text += ImTextCharFromUtf8(&c, in_text, in_text_end);
         if (c == 0)
             break;
-        if (c < 0x10000)
-            char_count++;
+        char_count++;
     }
     return char_count;
 }
@@ -1732,11 +2130,15 @@ static inline int ImTextCharToUtf8(char* buf, int buf_size, unsigned int c)
         buf[1] = (char)(0x80 + (c & 0x3f));
         return 2;
     }
-    if (c >= 0xdc00 && c < 0xe000)
+    if (c < 0x10000)
     {
-        return 0;
+        if (buf_size < 3) return 0;
+        buf[0] = (char)(0xe0 + (c >> 12));
+        buf[1] = (char)(0x80 + ((c>> 6) & 0x3f));
+        buf[2] = (char)(0x80 + ((c ) & 0x3f));
+        return 3;
     }
-    if (c >= 0xd800 && c < 0xdc00)
+    if (c <= 0x10FFFF)
     {
         if (buf_size < 4) return 0;
         buf[0] = (char)(0xf0 + (c >> 18));
@@ -1745,14 +2147,8 @@ static inline int ImTextCharToUtf8(char* buf, int buf_size, unsigned int c)
         buf[3] = (char)(0x80 + ((c ) & 0x3f));
         return 4;
     }
-    //else if (c < 0x10000)
-    {
-        if (buf_size < 3) return 0;
-        buf[0] = (char)(0xe0 + (c >> 12));
-        buf[1] = (char)(0x80 + ((c>> 6) & 0x3f));
-        buf[2] = (char)(0x80 + ((c ) & 0x3f));
-        return 3;
-    }
+    // Invalid code point, the max unicode is 0x10FFFF
+    return 0;
 }
 
 // Not optimal but we very rarely use this function.
@@ -1766,8 +2162,8 @@ static inline int ImTextCountUtf8BytesFromChar(unsigned int c)
 {
     if (c < 0x80) return 1;
     if (c < 0x800) return 2;
-    if (c >= 0xdc00 && c < 0xe000) return 0;
-    if (c >= 0xd800 && c < 0xdc00) return 4;
+    if (c < 0x10000) return 3;
+    if (c <= 0x10FFFF) return 4;
     return 3;
 }
 
@@ -1777,6 +2173,30 @@ int ImTextStrToUtf8(char* buf, int buf_size, const ImWchar* in_text, const ImWch
     const char* buf_end = buf + buf_size;
     while (buf_out < buf_end-1 && (!in_text_end || in_text < in_text_end) && *in_text)
     {
+#if (defined(IMGUI_ENABLE_SSE) || defined(IMGUI_ENABLE_NEON)) && !defined(IMGUI_USE_WCHAR32)
+        // Fast path: narrow blocks of 8 ASCII characters at once
+        if (in_text_end)
+            while (in_text_end - in_text >= 8 && buf_end - 1 - buf_out >= 8)
+            {
+#if defined(IMGUI_ENABLE_SSE)
+                const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)in_text);
+                const __m128i ascii = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_setzero_si128()), _mm_cmplt_epi16(v, _mm_set1_epi16(0x80)));
+                if (_mm_movemask_epi8(ascii) != 0xFFFF)
+                    break;
+                _mm_storel_epi64((__m128i*)(void*)buf_out, _mm_packus_epi16(v, v));
+#else
+                const uint16x8_t v = vld1q_u16((const uint16_t*)in_text);
+                const uint64x2_t ascii = vreinterpretq_u64_u16(vcltq_u16(vsubq_u16(v, vdupq_n_u16(1)), vdupq_n_u16(0x7F)));
+                if ((vgetq_lane_u64(ascii, 0) & vgetq_lane_u64(ascii, 1)) != ~(ImU64)0)
+                    break;
+                vst1_u8((uint8_t*)(void*)buf_out, vmovn_u16(v));
+#endif
+                in_text += 8;
+                buf_out += 8;
+            }
+        if (buf_out >= buf_end-1 || (in_text_end && in_text >= in_text_end) || !*in_text)
+            break;
+#endif
         unsigned int c = (unsigned int)(*in_text++);
         if (c < 0x80)
             *buf_out++ = (char)c;
@@ -2105,10 +2525,52 @@ void ImGuiTextFilter::ImGuiTextRange::split(char separator, ImVector<ImGuiTextRa
         out->push_back(ImGuiTextRange(wb, we));
 }
 
+// Return true if all text rejected by 'old_filter' is also rejected by 'new_filter', so cached rejections remain valid.
+// This is the case when characters were appended to the last term of the filter, if that term is not an exclusion (e.g. typing "abc" -> "abcd" or "-x,ab" -> "-x,abc").
+static bool TextFilterIsNarrowing(const char* old_filter, int old_len, const char* new_filter, int new_len)
+{
+    if (old_len >= new_len || memcmp(old_filter, new_filter, (size_t)old_len) != 0 || ImStrchrRange(new_filter + old_len, new_filter + new_len, ',') != NULL)
+        return false;
+    const char* old_filter_end = old_filter + old_len;
+    const char* last_term = old_filter_end;
+    while (last_term > old_filter && last_term[-1] != ',')
+        last_term--;
+    while (last_term < old_filter_end && ImCharIsBlankA(*last_term))
+        last_term++;
+    return last_term < old_filter_end && *last_term != '-';
+}
+
 void ImGuiTextFilter::Build()
 {
+    // Filters are made from a lowercase copy of InputBuf, for PassFilter() to search them faster. Find out which results of PassFilterCached() remain valid
+    char input_lower[IM_ARRAYSIZE(InputBuf)];
+    int input_len = 0;
+    for (; input_len < IM_ARRAYSIZE(InputBuf) - 1 && InputBuf[input_len] != 0; input_len++)
+        input_lower[input_len] = ImCharToLowerA(InputBuf[input_len]);
+    input_lower[input_len] = 0;
+    if (CacheTested.Size > 0)
+    {
+        const int old_len = InputBufLower.Size > 0 ? InputBufLower.Size - 1 : 0;
+        if (old_len == input_len && memcmp(InputBufLower.Data, input_lower, (size_t)input_len) == 0)
+        {
+            // Unchanged (the search is case-insensitive): keep all results
+        }
+        else if (TextFilterIsNarrowing(InputBufLower.Data, old_len, input_lower, input_len))
+        {
+            // Lines rejected so far are still rejected, lines which passed need to be tested again
+            for (int n = 0; n < CacheTested.Size; n++)
+                CacheTested[n] &= ~CachePassed[n];
+        }
+        else
+        {
+            ClearCache();
+        }
+    }
+    InputBufLower.resize(input_len + 1);
+    memcpy(InputBufLower.Data, input_lower, (size_t)input_len + 1);
+
     Filters.resize(0);
-    ImGuiTextRange input_range(InputBuf, InputBuf+strlen(InputBuf));
+    ImGuiTextRange input_range(InputBufLower.Data, InputBufLower.Data+input_len);
     input_range.split(',', &Filters);
 
     CountGrep = 0;
@@ -2132,7 +2594,9 @@ bool ImGuiTextFilter::PassFilter(const char* text, const char* text_end) const
         return true;
 
     if (text == NULL)
-        text = "";
+        text = text_end = "";
+    if (text_end == NULL)
+        text_end = text + strlen(text);
 
     for (int i = 0; i != Filters.Size; i++)
     {
@@ -2142,13 +2606,13 @@ bool ImGuiTextFilter::PassFilter(const char* text, const char* text_end) const
         if (f.b[0] == '-')
         {
             // Subtract
-            if (ImStristr(text, text_end, f.b + 1, f.e) != NULL)
+            if (f.e - f.b > 1 && ImStristrLower(text, text_end, f.b + 1, f.e) != NULL)
                 return false;
         }
         else
         {
             // Grep
-            if (ImStristr(text, text_end, f.b, f.e) != NULL)
+            if (ImStristrLower(text, text_end, f.b, f.e) != NULL)
                 return true;
         }
     }
@@ -2160,6 +2624,31 @@ bool ImGuiTextFilter::PassFilter(const char* text, const char* text_end) const
     return false;
 }
 
+bool ImGuiTextFilter::PassFilterCached(int line_n, const char* text, const char* text_end)
+{
+    IM_ASSERT(line_n >= 0);
+    if (Filters.empty())
+        return true;
+
+    const int word_n = line_n >> 5;
+    const ImU32 mask = (ImU32)1 << (line_n & 31);
+    if (word_n >= CacheTested.Size)
+    {
+        CacheTested.resize(word_n + 1, 0);
+        CachePassed.resize(word_n + 1, 0);
+    }
+    if (CacheTested[word_n] & mask)
+        return (CachePassed[word_n] & mask) != 0;
+
+    const bool passed = PassFilter(text, text_end);
+    CacheTested[word_n] |= mask;
+    if (passed)
+        CachePassed[word_n] |= mask;
+    else
+        CachePassed[word_n] &= ~mask;
+    return passed;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] ImGuiTextBuffer
 //-----------------------------------------------------------------------------
@@ -2208,15 +2697,35 @@ void ImGuiTextBuffer::appendfv(const char* fmt, va_list args)
     va_list args_copy;
     va_copy(args_copy, args);
 
-    int len = ImFormatStringV(NULL, 0, fmt, args);         // FIXME-OPT: could do a first pass write attempt, likely successful on first pass.
+    // Add zero-terminator the first time
+    const int write_off = (Buf.Size != 0) ? Buf.Size : 1;
+
+    // Try writing in the spare capacity first, which generally succeeds, instead of measuring then writing.
+    // A result shorter than the space available means the output wasn't truncated.
+    const int write_avail = Buf.Capacity - (write_off - 1);
+    if (write_avail > 1)
+    {
+        const int len = ImFormatStringV(Buf.Data + write_off - 1, (size_t)write_avail, fmt, args);
+        if (len >= 0 && len < write_avail - 1)
+        {
+            if (len > 0)
+                Buf.resize(write_off + len);
+            va_end(args_copy);
+            return;
+        }
+        Buf.Data[write_off - 1] = 0;
+    }
+
+    va_list args_copy_for_write;
+    va_copy(args_copy_for_write, args_copy);
+    int len = ImFormatStringV(NULL, 0, fmt, args_copy);
+    va_end(args_copy);
     if (len <= 0)
     {
-        va_end(args_copy);
+        va_end(args_copy_for_write);
         return;
     }
 
-    // Add zero-terminator the first time
-    const int write_off = (Buf.Size != 0) ? Buf.Size : 1;
     const int needed_sz = write_off + len;
     if (write_off + len >= Buf.Capacity)
     {
@@ -2225,8 +2734,8 @@ void ImGuiTextBuffer::appendfv(const char* fmt, va_list args)
     }
 
     Buf.resize(needed_sz);
-    ImFormatStringV(&Buf[write_off - 1], (size_t)len + 1, fmt, args_copy);
-    va_end(args_copy);
+    ImFormatStringV(&Buf[write_off - 1], (size_t)len + 1, fmt, args_copy_for_write);
+    va_end(args_copy_for_write);
 }
 
 //-----------------------------------------------------------------------------
@@ -2830,6 +3339,174 @@ void ImGui::GcAwakeTransientWindowBuffers(ImGuiWindow* window)
     window->MemoryDrawListIdxCapacity = window->MemoryDrawListVtxCapacity = 0;
 }
 
+// Discard persistent storage of a window: tree nodes open/close state, columns widths, etc.
+// Unlike GcCompactTransientWindowBuffers() this has visible side-effects, so it is only used when enforcing io.ConfigMemoryCompactBudget.
+void ImGui::GcDiscardWindowStorage(ImGuiWindow* window)
+{
+    window->StateStorage.Clear();
+    for (int i = 0; i != window->ColumnsStorage.Size; i++)
+        window->ColumnsStorage[i].~ImGuiColumns();
+    window->ColumnsStorage.clear();
+}
+
+template<typename T>
+static inline size_t GcCalcVectorBytes(const ImVector<T>& v)
+{
+    return (size_t)v.Capacity * sizeof(T);
+}
+
+static size_t GcCalcDrawListBytes(const ImDrawList* draw_list)
+{
+    size_t bytes = GcCalcVectorBytes(draw_list->CmdBuffer) + GcCalcVectorBytes(draw_list->IdxBuffer) + GcCalcVectorBytes(draw_list->VtxBuffer);
+    bytes += GcCalcVectorBytes(draw_list->_ClipRectStack) + GcCalcVectorBytes(draw_list->_TextureIdStack) + GcCalcVectorBytes(draw_list->_Path);
+    bytes += GcCalcVectorBytes(draw_list->_Splitter._Channels);
+    for (int i = 0; i < draw_list->_Splitter._Channels.Size; i++)
+        bytes += GcCalcVectorBytes(draw_list->_Splitter._Channels[i]._CmdBuffer) + GcCalcVectorBytes(draw_list->_Splitter._Channels[i]._IdxBuffer);
+    return bytes;
+}
+
+static void GcCalcWindowMemoryStats(ImGuiWindow* window, ImGuiMemoryStats* out_stats)
+{
+    out_stats->Bytes[ImGuiMemoryCategory_Windows] += sizeof(ImGuiWindow) + strlen(window->Name) + 1;
+    out_stats->Bytes[ImGuiMemoryCategory_DrawLists] += GcCalcDrawListBytes(window->DrawList);
+
+    ImGuiWindowTempData& dc = window->DC;
+    size_t buffers_bytes = GcCalcVectorBytes(window->IDStack) + GcCalcVectorBytes(dc.ChildWindows) + GcCalcVectorBytes(dc.ItemFlagsStack) + GcCalcVectorBytes(dc.ItemWidthStack);
+    buffers_bytes += GcCalcVectorBytes(dc.TextWrapPosStack) + GcCalcVectorBytes(dc.GroupStack);
+    out_stats->Bytes[ImGuiMemoryCategory_WindowBuffers] += buffers_bytes;
+
+    size_t storage_bytes = GcCalcVectorBytes(window->StateStorage.Data) + GcCalcVectorBytes(window->ColumnsStorage);
+    for (int i = 0; i < window->ColumnsStorage.Size; i++)
+        storage_bytes += GcCalcVectorBytes(window->ColumnsStorage[i].Columns);
+    out_stats->Bytes[ImGuiMemoryCategory_WindowStorage] += storage_bytes;
+}
+
+static size_t GcCalcTabBarBytes(const ImGuiTabBar* tab_bar)
+{
+    return GcCalcVectorBytes(tab_bar->Tabs) + GcCalcVectorBytes(tab_bar->TabsNames.Buf);
+}
+
+// Report heap memory owned by the current context, per category.
+// This walks all windows so it is not meant to be called every frame. Shared font atlas data is not included.
+void ImGui::GcCalcMemoryStats(ImGuiMemoryStats* out_stats)
+{
+    ImGuiContext& g = *GImGui;
+    *out_stats = ImGuiMemoryStats();
+    for (int i = 0; i != g.Windows.Size; i++)
+        GcCalcWindowMemoryStats(g.Windows[i], out_stats);
+
+    out_stats->Bytes[ImGuiMemoryCategory_DrawLists] += GcCalcDrawListBytes(&g.BackgroundDrawList) + GcCalcDrawListBytes(&g.ForegroundDrawList);
+    for (int i = 0; i < IM_ARRAYSIZE(g.DrawDataBuilder.Layers); i++)
+        out_stats->Bytes[ImGuiMemoryCategory_DrawLists] += GcCalcVectorBytes(g.DrawDataBuilder.Layers[i]);
+
+    size_t tab_bars_bytes = GcCalcVectorBytes(g.TabBars.Data) + GcCalcVectorBytes(g.TabBars.Map.Data);
+    for (int n = 0; n < g.TabBars.Map.Data.Size; n++)
+        if (g.TabBars.Map.Data[n].val_i != -1)
+            tab_bars_bytes += GcCalcTabBarBytes(g.TabBars.GetByIndex(g.TabBars.Map.Data[n].val_i));
+    out_stats->Bytes[ImGuiMemoryCategory_TabBars] = tab_bars_bytes;
+
+    ImGuiInputTextState& input_text = g.InputTextState;
+    out_stats->Bytes[ImGuiMemoryCategory_InputText] = GcCalcVectorBytes(input_text.TextA) + GcCalcVectorBytes(input_text.InitialTextA) + GcCalcVectorBytes(input_text.LineStarts);
+    const ImGuiInputTextUndoState& input_text_undo = input_text.Stb.undostate;
+    out_stats->Bytes[ImGuiMemoryCategory_InputText] += GcCalcVectorBytes(input_text_undo.UndoStack.Records) + GcCalcVectorBytes(input_text_undo.UndoStack.Chars) + GcCalcVectorBytes(input_text_undo.RedoStack.Records) + GcCalcVectorBytes(input_text_undo.RedoStack.Chars);
+
+    size_t settings_bytes = GcCalcVectorBytes(g.SettingsWindows) + GcCalcVectorBytes(g.SettingsHandlers) + GcCalcVectorBytes(g.SettingsIniData.Buf) + GcCalcVectorBytes(g.SettingsIniDataNext.Buf);
+    settings_bytes += GcCalcVectorBytes(g.SettingsWindowsMap.Data);
+    for (int i = 0; i != g.SettingsWindows.Size; i++)
+        settings_bytes += strlen(g.SettingsWindows[i].Name) + 1;
+    out_stats->Bytes[ImGuiMemoryCategory_Settings] = settings_bytes;
+
+    size_t misc_bytes = GcCalcVectorBytes(g.Windows) + GcCalcVectorBytes(g.WindowsFocusOrder) + GcCalcVectorBytes(g.WindowsSortBuffer) + GcCalcVectorBytes(g.WindowsActiveRoots);
+    misc_bytes += GcCalcVectorBytes(g.CurrentWindowStack) + GcCalcVectorBytes(g.WindowsById.Data);
+    misc_bytes += GcCalcVectorBytes(g.ColorModifiers) + GcCalcVectorBytes(g.StyleModifiers) + GcCalcVectorBytes(g.FontStack);
+    misc_bytes += GcCalcVectorBytes(g.OpenPopupStack) + GcCalcVectorBytes(g.BeginPopupStack) + GcCalcVectorBytes(g.CurrentTabBarStack) + GcCalcVectorBytes(g.ShrinkWidthBuffer);
+    misc_bytes += GcCalcVectorBytes(g.PrivateClipboard) + GcCalcVectorBytes(g.LogBuffer.Buf) + GcCalcVectorBytes(g.DataTypeFormatCache);
+    out_stats->Bytes[ImGuiMemoryCategory_Misc] = misc_bytes;
+}
+
+static int IMGUI_CDECL GcWindowLastFrameActiveComparer(const void* lhs, const void* rhs)
+{
+    const ImGuiWindow* a = *(const ImGuiWindow* const *)lhs;
+    const ImGuiWindow* b = *(const ImGuiWindow* const *)rhs;
+    return a->LastFrameActive - b->LastFrameActive;
+}
+
+static int IMGUI_CDECL GcTabBarLastFrameVisibleComparer(const void* lhs, const void* rhs)
+{
+    const ImGuiTabBar* a = *(const ImGuiTabBar* const *)lhs;
+    const ImGuiTabBar* b = *(const ImGuiTabBar* const *)rhs;
+    return a->CurrFrameVisible - b->CurrFrameVisible;
+}
+
+// Free memory of unused windows and tab bars, least recently used first, until the memory owned by the context fits within 'budget'.
+// - Pass 1: compact transient buffers of inactive windows and of the inactive InputText state. No visible side-effects.
+// - Pass 2: discard persistent storage of inactive windows (see GcDiscardWindowStorage()).
+// - Pass 3: discard tab bars of inactive windows (they will reset to their first tab).
+// Active windows are never touched, including tab bars they don't currently submit (e.g. inside a closed tree node), so the budget is a target and may not be reached.
+void ImGui::GcCompactToMemoryBudget(size_t budget)
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiMemoryStats stats;
+    GcCalcMemoryStats(&stats);
+    size_t total_bytes = stats.GetTotal();
+    if (total_bytes <= budget)
+        return;
+
+    // Gather inactive windows, least recently used first
+    ImVector<ImGuiWindow*> windows;
+    for (int i = 0; i != g.Windows.Size; i++)
+        if (!g.Windows[i]->Active && !g.Windows[i]->WasActive)
+            windows.push_back(g.Windows[i]);
+    if (windows.Size > 1)
+        ImQsort(windows.Data, (size_t)windows.Size, sizeof(ImGuiWindow*), GcWindowLastFrameActiveComparer);
+
+    // Pass 1
+    if (g.InputTextState.ID != 0 && g.InputTextState.ID != g.ActiveId && g.InputTextState.ID != g.ActiveIdPreviousFrame)
+    {
+        total_bytes -= stats.Bytes[ImGuiMemoryCategory_InputText];
+        g.InputTextState.ClearFreeMemory();
+        g.InputTextState.ID = 0;
+    }
+    for (int i = 0; i < windows.Size && total_bytes > budget; i++)
+        if (!windows[i]->MemoryCompacted)
+        {
+            ImGuiMemoryStats window_stats_before, window_stats_after;
+            GcCalcWindowMemoryStats(windows[i], &window_stats_before);
+            GcCompactTransientWindowBuffers(windows[i]);
+            GcCalcWindowMemoryStats(windows[i], &window_stats_after);
+            total_bytes -= window_stats_before.GetTotal() - window_stats_after.GetTotal();
+        }
+
+    // Pass 2
+    for (int i = 0; i < windows.Size && total_bytes > budget; i++)
+    {
+        ImGuiMemoryStats window_stats;
+        GcCalcWindowMemoryStats(windows[i], &window_stats);
+        total_bytes -= window_stats.Bytes[ImGuiMemoryCategory_WindowStorage];
+        GcDiscardWindowStorage(windows[i]);
+    }
+
+    // Pass 3
+    if (total_bytes > budget)
+    {
+        ImVector<ImGuiTabBar*> tab_bars;
+        for (int n = 0; n < g.TabBars.Map.Data.Size; n++)
+            if (g.TabBars.Map.Data[n].val_i != -1)
+            {
+                ImGuiTabBar* tab_bar = g.TabBars.GetByIndex(g.TabBars.Map.Data[n].val_i);
+                if (tab_bar->Window == NULL || (!tab_bar->Window->Active && !tab_bar->Window->WasActive))
+                    tab_bars.push_back(tab_bar);
+            }
+        if (tab_bars.Size > 1)
+            ImQsort(tab_bars.Data, (size_t)tab_bars.Size, sizeof(ImGuiTabBar*), GcTabBarLastFrameVisibleComparer);
+        for (int i = 0; i < tab_bars.Size && total_bytes > budget; i++)
+        {
+            total_bytes -= GcCalcTabBarBytes(tab_bars[i]);
+            g.TabBars.Remove(tab_bars[i]->ID, tab_bars[i]);
+        }
+    }
+}
+
 void ImGui::SetNavID(ImGuiID id, int nav_layer)
 {
     ImGuiContext& g = *GImGui;
@@ -3276,6 +3953,13 @@ void ImGui::SetAllocatorFunctions(void* (*alloc_func)(size_t sz, void* user_data
     GImAllocatorUserData = user_data;
 }
 
+void ImGui::GetAllocatorFunctions(void* (**p_alloc_func)(size_t sz, void* user_data), void (**p_free_func)(void* ptr, void* user_data), void** p_user_data)
+{
+    *p_alloc_func = GImAllocatorAllocFunc;
+    *p_free_func = GImAllocatorFreeFunc;
+    *p_user_data = GImAllocatorUserData;
+}
+
 ImGuiContext* ImGui::CreateContext(ImFontAtlas* shared_font_atlas)
 {
     ImGuiContext* ctx = IM_NEW(ImGuiContext)(shared_font_atlas);
@@ -3724,9 +4408,17 @@ void ImGui::NewFrame()
     g.FrameCount += 1;
     g.TooltipOverrideCount = 0;
     g.WindowsActiveCount = 0;
+    g.WindowsNewlyActiveCount = 0;
+    g.DataTypeFormatCacheMisses = 0;
 
     // Setup current font and draw list shared data
-    g.IO.Fonts->Locked = true;
+    // An atlas which is already locked (e.g. shared with contexts running on other threads) is left untouched.
+    if (!g.IO.Fonts->Locked)
+    {
+        ImFontAtlasBuildUpdateDynamicGlyphs(g.IO.Fonts);
+        g.IO.Fonts->Locked = true;
+        g.FontAtlasLockedByContext = true;
+    }
     SetCurrentFont(GetDefaultFont());
     IM_ASSERT(g.Font->IsLoaded());
     g.DrawListSharedData.ClipRectFullscreen = ImVec4(0.0f, 0.0f, g.IO.DisplaySize.x, g.IO.DisplaySize.y);
@@ -3871,6 +4563,17 @@ void ImGui::NewFrame()
             GcCompactTransientWindowBuffers(window);
     }
 
+    // Enforce memory budget. This walks every window so we only do it periodically.
+    if (g.IO.ConfigMemoryCompactBudget > 0)
+    {
+        g.GcMemoryBudgetTimer -= g.IO.DeltaTime;
+        if (g.GcMemoryBudgetTimer <= 0.0f)
+        {
+            GcCompactToMemoryBudget(g.IO.ConfigMemoryCompactBudget);
+            g.GcMemoryBudgetTimer = GC_MEMORY_BUDGET_CHECK_INTERVAL;
+        }
+    }
+
     // Closing the focused window restore focus to the first active root window in descending z-order
     if (g.NavWindow && !g.NavWindow->WasActive)
         FocusTopMostWindowUnderOne(NULL, NULL);
@@ -3946,6 +4649,7 @@ void ImGui::Shutdown(ImGuiContext* context)
     if (g.IO.Fonts && g.FontAtlasOwnedByContext)
     {
         g.IO.Fonts->Locked = false;
+        g.FontAtlasLockedByContext = false;
         IM_DELETE(g.IO.Fonts);
     }
     g.IO.Fonts = NULL;
@@ -3969,6 +4673,7 @@ void ImGui::Shutdown(ImGuiContext* context)
     g.Windows.clear();
     g.WindowsFocusOrder.clear();
     g.WindowsSortBuffer.clear();
+    g.WindowsActiveRoots.clear();
     g.CurrentWindow = NULL;
     g.CurrentWindowStack.clear();
     g.WindowsById.Clear();
@@ -3991,10 +4696,12 @@ void ImGui::Shutdown(ImGuiContext* context)
 
     g.PrivateClipboard.clear();
     g.InputTextState.ClearFreeMemory();
+    g.DataTypeFormatCache.clear();
 
     for (int i = 0; i < g.SettingsWindows.Size; i++)
         IM_DELETE(g.SettingsWindows[i].Name);
     g.SettingsWindows.clear();
+    g.SettingsWindowsMap.Clear();
     g.SettingsHandlers.clear();
 
     if (g.LogFile && g.LogFile != stdout)
@@ -4024,9 +4731,8 @@ static void AddWindowToSortBuffer(ImVector<ImGuiWindow*>* out_sorted_windows, Im
     out_sorted_windows->push_back(window);
     if (window->Active)
     {
+        // DC.ChildWindows[] is kept sorted by Begin(), see ChildWindowComparer()
         int count = window->DC.ChildWindows.Size;
-        if (count > 1)
-            ImQsort(window->DC.ChildWindows.Data, (size_t)count, sizeof(ImGuiWindow*), ChildWindowComparer);
         for (int i = 0; i < count; i++)
         {
             ImGuiWindow* child = window->DC.ChildWindows[i];
@@ -4186,7 +4892,13 @@ void ImGui::EndFrame()
     // Hide implicit/fallback "Debug" window if it hasn't been used
     g.FrameScopePushedImplicitWindow = false;
     if (g.CurrentWindow && !g.CurrentWindow->WriteAccessed)
+    {
+        // Don't let the implicit window toggling off->on every frame invalidate the window sort
+        if (!g.CurrentWindow->WasActive)
+            g.WindowsNewlyActiveCount--;
+        g.WindowsActiveCount--;
         g.CurrentWindow->Active = false;
+    }
     End();
 
     // Show CTRL+TAB list window
@@ -4219,23 +4931,40 @@ void ImGui::EndFrame()
 
     // Sort the window list so that all child windows are after their parent
     // We cannot do that on FocusWindow() because childs may not exist yet
-    g.WindowsSortBuffer.resize(0);
-    g.WindowsSortBuffer.reserve(g.Windows.Size);
-    for (int i = 0; i != g.Windows.Size; i++)
+    // The result only depends on the previous order, the set of active windows and parent-child links: if none of them changed, the list is already sorted.
+    // (if no window got activated and the active count is unchanged, then the set of active windows is unchanged)
+    if (g.WindowsSortDirty || g.WindowsNewlyActiveCount > 0 || g.WindowsActiveCount != g.WindowsActiveCountPrev)
     {
-        ImGuiWindow* window = g.Windows[i];
-        if (window->Active && (window->Flags & ImGuiWindowFlags_ChildWindow))       // if a child is active its parent will add it
-            continue;
-        AddWindowToSortBuffer(&g.WindowsSortBuffer, window);
-    }
+        g.WindowsSortBuffer.resize(0);
+        g.WindowsSortBuffer.reserve(g.Windows.Size);
+        for (int i = 0; i != g.Windows.Size; i++)
+        {
+            ImGuiWindow* window = g.Windows[i];
+            if (window->Active && (window->Flags & ImGuiWindowFlags_ChildWindow))       // if a child is active its parent will add it
+                continue;
+            AddWindowToSortBuffer(&g.WindowsSortBuffer, window);
+        }
+
+        // This usually assert if there is a mismatch between the ImGuiWindowFlags_ChildWindow / ParentWindow values and DC.ChildWindows[] in parents, aka we've done something wrong.
+        IM_ASSERT(g.Windows.Size == g.WindowsSortBuffer.Size);
+        g.Windows.swap(g.WindowsSortBuffer);
 
-    // This usually assert if there is a mismatch between the ImGuiWindowFlags_ChildWindow / ParentWindow values and DC.ChildWindows[] in parents, aka we've done something wrong.
-    IM_ASSERT(g.Windows.Size == g.WindowsSortBuffer.Size);
-    g.Windows.swap(g.WindowsSortBuffer);
+        // Cache the active root windows in display order, so Render() doesn't have to walk every window
+        g.WindowsActiveRoots.resize(0);
+        for (int i = 0; i != g.Windows.Size; i++)
+            if (g.Windows[i]->Active && !(g.Windows[i]->Flags & ImGuiWindowFlags_ChildWindow))
+                g.WindowsActiveRoots.push_back(g.Windows[i]);
+        g.WindowsSortDirty = false;
+    }
+    g.WindowsActiveCountPrev = g.WindowsActiveCount;
     g.IO.MetricsActiveWindows = g.WindowsActiveCount;
 
     // Unlock font atlas
-    g.IO.Fonts->Locked = false;
+    if (g.FontAtlasLockedByContext)
+    {
+        g.IO.Fonts->Locked = false;
+        g.FontAtlasLockedByContext = false;
+    }
 
     // Clear Input data for next frame
     g.IO.MouseWheel = g.IO.MouseWheelH = 0.0f;
@@ -4261,10 +4990,10 @@ void ImGui::Render()
     ImGuiWindow* windows_to_render_top_most[2];
     windows_to_render_top_most[0] = (g.NavWindowingTarget && !(g.NavWindowingTarget->Flags & ImGuiWindowFlags_NoBringToFrontOnFocus)) ? g.NavWindowingTarget->RootWindow : NULL;
     windows_to_render_top_most[1] = g.NavWindowingTarget ? g.NavWindowingList : NULL;
-    for (int n = 0; n != g.Windows.Size; n++)
+    for (int n = 0; n != g.WindowsActiveRoots.Size; n++)
     {
-        ImGuiWindow* window = g.Windows[n];
-        if (IsWindowActiveAndVisible(window) && (window->Flags & ImGuiWindowFlags_ChildWindow) == 0 && window != windows_to_render_top_most[0] && window != windows_to_render_top_most[1])
+        ImGuiWindow* window = g.WindowsActiveRoots[n];
+        if (IsWindowActiveAndVisible(window) && window != windows_to_render_top_most[0] && window != windows_to_render_top_most[1])
             AddRootWindowToDrawData(window);
     }
     for (int n = 0; n < IM_ARRAYSIZE(windows_to_render_top_most); n++)
@@ -4896,6 +5625,7 @@ static ImGuiWindow* CreateNewWindow(const char* name, ImVec2 size, ImGuiWindowFl
     }
 
     g.WindowsFocusOrder.push_back(window);
+    g.WindowsSortDirty = true;
     if (flags & ImGuiWindowFlags_NoBringToFrontOnFocus)
         g.Windows.push_front(window); // Quite slow but rare and only once
     else
@@ -5435,10 +6165,13 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
     // Update Flags, LastFrameActive, BeginOrderXXX fields
     if (first_begin_of_the_frame)
     {
+        if ((window->Flags ^ flags) & (ImGuiWindowFlags_ChildWindow | ImGuiWindowFlags_Popup | ImGuiWindowFlags_Tooltip))
+            g.WindowsSortDirty = true;
+        if (!window->WasActive)
+            g.WindowsNewlyActiveCount++;
         window->Flags = (ImGuiWindowFlags)flags;
         window->LastFrameActive = current_frame;
         window->LastTimeActive = (float)g.Time;
-        window->BeginOrderWithinParent = 0;
         window->BeginOrderWithinContext = (short)(g.WindowsActiveCount++);
     }
     else
@@ -5512,6 +6245,8 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
     {
         // Initialize
         const bool window_is_child_tooltip = (flags & ImGuiWindowFlags_ChildWindow) && (flags & ImGuiWindowFlags_Tooltip); // FIXME-WIP: Undocumented behavior of Child+Tooltip for pinned tooltip (#1345)
+        if ((flags & ImGuiWindowFlags_ChildWindow) && window->ParentWindow != parent_window)
+            g.WindowsSortDirty = true;
         UpdateWindowParentAndRootLinks(window, flags, parent_window);
 
         window->Active = true;
@@ -5658,11 +6393,24 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
         if (flags & ImGuiWindowFlags_ChildWindow)
         {
             IM_ASSERT(parent_window && parent_window->Active);
-            window->BeginOrderWithinParent = (short)parent_window->DC.ChildWindows.Size;
-            parent_window->DC.ChildWindows.push_back(window);
+            const short begin_order_within_parent = (short)parent_window->DC.ChildWindows.Size;
+            if (window->BeginOrderWithinParent != begin_order_within_parent)
+                g.WindowsSortDirty = true;
+            window->BeginOrderWithinParent = begin_order_within_parent;
+
+            // Insert sorted so the list never needs a full sort: we come last in submission order, so only popups/tooltips may need to stay after us.
+            ImVector<ImGuiWindow*>& siblings = parent_window->DC.ChildWindows;
+            int insert_n = siblings.Size;
+            while (insert_n > 0 && ChildWindowComparer(&siblings[insert_n - 1], &window) > 0)
+                insert_n--;
+            siblings.insert(siblings.Data + insert_n, window);
             if (!(flags & ImGuiWindowFlags_Popup) && !window_pos_set_by_api && !window_is_child_tooltip)
                 window->Pos = parent_window->DC.CursorPos;
         }
+        else
+        {
+            window->BeginOrderWithinParent = 0;
+        }
 
         const bool window_pos_with_pivot = (window->SetWindowPosVal.x != FLT_MAX && window->HiddenFramesCannotSkipItems == 0);
         if (window_pos_with_pivot)
@@ -6065,6 +6813,7 @@ void ImGui::BringWindowToDisplayFront(ImGuiWindow* window)
         {
             memmove(&g.Windows[i], &g.Windows[i + 1], (size_t)(g.Windows.Size - i - 1) * sizeof(ImGuiWindow*));
             g.Windows[g.Windows.Size - 1] = window;
+            g.WindowsSortDirty = true;
             break;
         }
 }
@@ -6079,6 +6828,7 @@ void ImGui::BringWindowToDisplayBack(ImGuiWindow* window)
         {
             memmove(&g.Windows[1], &g.Windows[0], (size_t)i * sizeof(ImGuiWindow*));
             g.Windows[0] = window;
+            g.WindowsSortDirty = true;
             break;
         }
 }
@@ -9397,16 +10147,21 @@ ImGuiWindowSettings* ImGui::CreateNewWindowSettings(const char* name)
 #endif
     settings->Name = ImStrdup(name);
     settings->ID = ImHashStr(name);
+    g.SettingsWindowsMap.SetInt(settings->ID, g.SettingsWindows.Size - 1);
     return settings;
 }
 
+// Lines of entries loaded from .ini data are only parsed on first access here.
 ImGuiWindowSettings* ImGui::FindWindowSettings(ImGuiID id)
 {
     ImGuiContext& g = *GImGui;
-    for (int i = 0; i != g.SettingsWindows.Size; i++)
-        if (g.SettingsWindows[i].ID == id)
-            return &g.SettingsWindows[i];
-    return NULL;
+    const int settings_idx = g.SettingsWindowsMap.GetInt(id, -1);
+    if (settings_idx == -1)
+        return NULL;
+    ImGuiWindowSettings* settings = &g.SettingsWindows[settings_idx];
+    if (settings->WantParse)
+        SettingsHandlerWindow_ReadDeferredLines(&g, settings);
+    return settings;
 }
 
 ImGuiWindowSettings* ImGui::FindOrCreateWindowSettings(const char* name)
@@ -9452,8 +10207,15 @@ void ImGui::LoadIniSettingsFromMemory(const char* ini_data, size_t ini_size)
     memcpy(buf, ini_data, ini_size);
     buf[ini_size] = 0;
 
+    // Keep a copy of the .ini data: window settings lines are parsed from it on first use (see FindWindowSettings()),
+    // and unchanged window settings entries will be copied from it on save instead of being formatted again.
+    g.SettingsIniData.Buf.resize(0);
+    g.SettingsIniData.append(buf, buf_end);
+
     void* entry_data = NULL;
     ImGuiSettingsHandler* entry_handler = NULL;
+    ImGuiSettingsHandler* window_handler = FindSettingsHandler("Window");
+    ImGuiWindowSettings* window_settings = NULL; // Window settings entry whose lines we are skipping over
 
     char* line_end = NULL;
     for (char* line = buf; line < buf_end; line = line_end + 1)
@@ -9469,6 +10231,10 @@ void ImGui::LoadIniSettingsFromMemory(const char* ini_data, size_t ini_size)
             continue;
         if (line[0] == '[' && line_end > line && line_end[-1] == ']')
         {
+            if (window_settings)
+                window_settings->IniBodyLen = (int)(line - buf) - window_settings->IniBodyOffset;
+            window_settings = NULL;
+
             // Parse "[Type][Name]". Note that 'Name' can itself contains [] characters, which is acceptable with the current format and parsing code.
             line_end[-1] = 0;
             const char* name_end = line_end - 1;
@@ -9487,6 +10253,21 @@ void ImGui::LoadIniSettingsFromMemory(const char* ini_data, size_t ini_size)
             }
             entry_handler = FindSettingsHandler(type_start);
             entry_data = entry_handler ? entry_handler->ReadOpenFn(&g, entry_handler, name_start) : NULL;
+            if (entry_handler == window_handler && entry_data != NULL)
+            {
+                // Defer parsing of window settings lines, only record where they are (up to the next entry)
+                window_settings = (ImGuiWindowSettings*)entry_data;
+                const char* body = g.SettingsIniData.begin() + (line_end - buf);
+                while (*body == '\n' || *body == '\r')
+                    body++;
+                window_settings->WantParse = true;
+                window_settings->IniBodyOffset = (int)(body - g.SettingsIniData.begin());
+                window_settings->IniBodyLen = 0;
+            }
+        }
+        else if (window_settings != NULL)
+        {
+            continue;
         }
         else if (entry_handler != NULL && entry_data != NULL)
         {
@@ -9494,6 +10275,8 @@ void ImGui::LoadIniSettingsFromMemory(const char* ini_data, size_t ini_size)
             entry_handler->ReadLineFn(&g, entry_handler, entry_data, line);
         }
     }
+    if (window_settings)
+        window_settings->IniBodyLen = ImMax((int)(buf_end - buf) - window_settings->IniBodyOffset, 0);
     IM_FREE(buf);
     g.SettingsLoaded = true;
 }
@@ -9507,25 +10290,37 @@ void ImGui::SaveIniSettingsToDisk(const char* ini_filename)
 
     size_t ini_data_size = 0;
     const char* ini_data = SaveIniSettingsToMemory(&ini_data_size);
-    FILE* f = ImFileOpen(ini_filename, "wt");
+    if (g.IO.WriteIniFileFn != NULL)
+        g.IO.WriteIniFileFn(g.IO.IniUserData, ini_filename, ini_data, ini_data_size);
+}
+
+// Write to a temporary file first, so an error or interruption while writing won't leave a truncated .ini file behind.
+static void WriteIniFileFn_DefaultImpl(void*, const char* filename, const char* data, size_t data_size)
+{
+    ImGuiTextBuffer tmp_filename;
+    tmp_filename.appendf("%s.tmp", filename);
+    FILE* f = ImFileOpen(tmp_filename.c_str(), "wt");
     if (!f)
         return;
-    fwrite(ini_data, sizeof(char), ini_data_size, f);
-    fclose(f);
+    const bool ok = (fwrite(data, sizeof(char), data_size, f) == data_size);
+    if (fclose(f) != 0 || !ok || !ImFileRename(tmp_filename.c_str(), filename))
+        ImFileRemove(tmp_filename.c_str()); // Don't leave the temporary file behind, whatever failed
 }
 
 // Call registered handlers (e.g. SettingsHandlerWindow_WriteAll() + custom handlers) to write their stuff into a text buffer
+// We write into a separate buffer and only swap it with SettingsIniData at the end, so handlers may copy unchanged data from the previous output.
 const char* ImGui::SaveIniSettingsToMemory(size_t* out_size)
 {
     ImGuiContext& g = *GImGui;
     g.SettingsDirtyTimer = 0.0f;
-    g.SettingsIniData.Buf.resize(0);
-    g.SettingsIniData.Buf.push_back(0);
+    g.SettingsIniDataNext.Buf.resize(0);
+    g.SettingsIniDataNext.Buf.push_back(0);
     for (int handler_n = 0; handler_n < g.SettingsHandlers.Size; handler_n++)
     {
         ImGuiSettingsHandler* handler = &g.SettingsHandlers[handler_n];
-        handler->WriteAllFn(&g, handler, &g.SettingsIniData);
+        handler->WriteAllFn(&g, handler, &g.SettingsIniDataNext);
     }
+    g.SettingsIniData.Buf.swap(g.SettingsIniDataNext.Buf);
     if (out_size)
         *out_size = (size_t)g.SettingsIniData.size();
     return g.SettingsIniData.c_str();
@@ -9549,6 +10344,21 @@ static void SettingsHandlerWindow_ReadLine(ImGuiContext*, ImGuiSettingsHandler*,
     else if (sscanf(line, "Collapsed=%d", &i) == 1)     settings->Collapsed = (i != 0);
 }
 
+// Parse lines recorded by LoadIniSettingsFromMemory()
+static void SettingsHandlerWindow_ReadDeferredLines(ImGuiContext* ctx, ImGuiWindowSettings* settings)
+{
+    ImGuiContext& g = *ctx;
+    settings->WantParse = false;
+    const char* line = g.SettingsIniData.begin() + settings->IniBodyOffset;
+    const char* body_end = line + settings->IniBodyLen;
+    while (line < body_end)
+    {
+        const char* line_end = ImStrchrRange(line, body_end, '\n');
+        SettingsHandlerWindow_ReadLine(ctx, NULL, settings, line); // Lines are not zero-terminated but the sscanf() patterns stop on new lines
+        line = line_end ? line_end + 1 : body_end;
+    }
+}
+
 static void SettingsHandlerWindow_WriteAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf)
 {
     // Gather data from windows that were active during this session
@@ -9567,21 +10377,43 @@ static void SettingsHandlerWindow_WriteAll(ImGuiContext* ctx, ImGuiSettingsHandl
             window->SettingsIdx = g.SettingsWindows.index_from_ptr(settings);
         }
         IM_ASSERT(settings->ID == window->ID);
-        settings->Pos = ImVec2ih((short)window->Pos.x, (short)window->Pos.y);
-        settings->Size = ImVec2ih((short)window->SizeFull.x, (short)window->SizeFull.y);
-        settings->Collapsed = window->Collapsed;
+        const ImVec2ih pos((short)window->Pos.x, (short)window->Pos.y);
+        const ImVec2ih size((short)window->SizeFull.x, (short)window->SizeFull.y);
+        if (settings->WantParse || settings->Pos.x != pos.x || settings->Pos.y != pos.y || settings->Size.x != size.x || settings->Size.y != size.y || settings->Collapsed != window->Collapsed)
+        {
+            settings->Pos = pos;
+            settings->Size = size;
+            settings->Collapsed = window->Collapsed;
+            settings->WantParse = false;
+            settings->IniBodyOffset = -1;
+        }
     }
 
     // Write to text buffer
+    // Lines of unchanged entries (including entries that were never parsed) are copied from the previous data in g.SettingsIniData.
     buf->reserve(buf->size() + g.SettingsWindows.Size * 96); // ballpark reserve
     for (int i = 0; i != g.SettingsWindows.Size; i++)
     {
-        const ImGuiWindowSettings* settings = &g.SettingsWindows[i];
-        buf->appendf("[%s][%s]\n", handler->TypeName, settings->Name);
-        buf->appendf("Pos=%d,%d\n", settings->Pos.x, settings->Pos.y);
-        buf->appendf("Size=%d,%d\n", settings->Size.x, settings->Size.y);
-        buf->appendf("Collapsed=%d\n", settings->Collapsed);
-        buf->appendf("\n");
+        ImGuiWindowSettings* settings = &g.SettingsWindows[i];
+        buf->append("[");
+        buf->append(handler->TypeName);
+        buf->append("][");
+        buf->append(settings->Name);
+        buf->append("]\n");
+        const int body_offset = buf->size();
+        if (settings->IniBodyOffset != -1)
+        {
+            const char* body = g.SettingsIniData.begin() + settings->IniBodyOffset;
+            buf->append(body, body + settings->IniBodyLen);
+            if (settings->IniBodyLen == 0 || body[settings->IniBodyLen - 1] != '\n')
+                buf->append("\n");
+        }
+        else
+        {
+            buf->appendf("Pos=%d,%d\nSize=%d,%d\nCollapsed=%d\n\n", settings->Pos.x, settings->Pos.y, settings->Size.x, settings->Size.y, settings->Collapsed);
+        }
+        settings->IniBodyOffset = body_offset;
+        settings->IniBodyLen = buf->size() - body_offset;
     }
 }
 
@@ -9636,11 +10468,14 @@ static const char* GetClipboardTextFn_DefaultImpl(void*)
         ::CloseClipboard();
         return NULL;
     }
-    if (ImWchar* wbuf_global = (ImWchar*)::GlobalLock(wbuf_handle))
+    // Clipboard data is UTF-16 (with surrogate pairs), which doesn't match ImWchar when IMGUI_USE_WCHAR32 is defined: let Windows convert it.
+    if (const WCHAR* wbuf_global = (const WCHAR*)::GlobalLock(wbuf_handle))
     {
-        int buf_len = ImTextCountUtf8BytesFromStr(wbuf_global, NULL) + 1;
-        buf_local.resize(buf_len);
-        ImTextStrToUtf8(buf_local.Data, buf_len, wbuf_global, NULL);
+        int buf_len = ::WideCharToMultiByte(CP_UTF8, 0, wbuf_global, -1, NULL, 0, NULL, NULL);
+        buf_local.resize(buf_len > 0 ? buf_len : 1);
+        buf_local[0] = 0;
+        if (buf_len > 0)
+            ::WideCharToMultiByte(CP_UTF8, 0, wbuf_global, -1, buf_local.Data, buf_len, NULL, NULL);
     }
     ::GlobalUnlock(wbuf_handle);
     ::CloseClipboard();
@@ -9651,15 +10486,15 @@ static void SetClipboardTextFn_DefaultImpl(void*, const char* text)
 {
     if (!::OpenClipboard(NULL))
         return;
-    const int wbuf_length = ImTextCountCharsFromUtf8(text, NULL) + 1;
-    HGLOBAL wbuf_handle = ::GlobalAlloc(GMEM_MOVEABLE, (SIZE_T)wbuf_length * sizeof(ImWchar));
+    const int wbuf_length = ::MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+    HGLOBAL wbuf_handle = (wbuf_length > 0) ? ::GlobalAlloc(GMEM_MOVEABLE, (SIZE_T)wbuf_length * sizeof(WCHAR)) : NULL;
     if (wbuf_handle == NULL)
     {
         ::CloseClipboard();
         return;
     }
-    ImWchar* wbuf_global = (ImWchar*)::GlobalLock(wbuf_handle);
-    ImTextStrFromUtf8(wbuf_global, wbuf_length, text, NULL);
+    WCHAR* wbuf_global = (WCHAR*)::GlobalLock(wbuf_handle);
+    ::MultiByteToWideChar(CP_UTF8, 0, text, -1, wbuf_global, wbuf_length);
     ::GlobalUnlock(wbuf_handle);
     ::EmptyClipboard();
     if (::SetClipboardData(CF_UNICODETEXT, wbuf_handle) == NULL)
@@ -9786,13 +10621,12 @@ void ImGui::ShowMetricsWindow(bool* p_open)
     // State
     enum { WRT_OuterRect, WRT_OuterRectClipped, WRT_InnerRect, WRT_InnerClipRect, WRT_WorkRect, WRT_Contents, WRT_ContentsRegionRect, WRT_Count }; // Windows Rect Type
     const char* wrt_rects_names[WRT_Count] = { "OuterRect", "OuterRectClipped", "InnerRect", "InnerClipRect", "WorkRect", "Contents", "ContentsRegionRect" };
-    static bool show_windows_rects = false;
-    static int  show_windows_rect_type = WRT_WorkRect;
-    static bool show_windows_begin_order = false;
-    static bool show_drawcmd_clip_rects = true;
+    ImGuiContext& g = *GImGui;
+    ImGuiMetricsConfig* cfg = &g.DebugMetricsConfig;
+    if (cfg->ShowWindowsRectsType < 0)
+        cfg->ShowWindowsRectsType = WRT_WorkRect;
 
     // Basic info
-    ImGuiContext& g = *GImGui;
     ImGuiIO& io = ImGui::GetIO();
     ImGui::Text("Dear ImGui %s", ImGui::GetVersion());
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
@@ -9857,7 +10691,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                 ImFormatString(buf, IM_ARRAYSIZE(buf), "Draw %4d triangles, tex 0x%p, clip_rect (%4.0f,%4.0f)-(%4.0f,%4.0f)",
                     pcmd->ElemCount/3, (void*)(intptr_t)pcmd->TextureId, pcmd->ClipRect.x, pcmd->ClipRect.y, pcmd->ClipRect.z, pcmd->ClipRect.w);
                 bool pcmd_node_open = ImGui::TreeNode((void*)(pcmd - draw_list->CmdBuffer.begin()), "%s", buf);
-                if (show_drawcmd_clip_rects && fg_draw_list && ImGui::IsItemHovered())
+                if (GImGui->DebugMetricsConfig.ShowDrawCmdClipRects && fg_draw_list && ImGui::IsItemHovered())
                 {
                     ImRect clip_rect = pcmd->ClipRect;
                     ImRect vtxs_rect;
@@ -9999,8 +10833,40 @@ void ImGui::ShowMetricsWindow(bool* p_open)
 
     if (ImGui::TreeNode("TabBars", "Tab Bars (%d)", g.TabBars.Data.Size))
     {
-        for (int n = 0; n < g.TabBars.Data.Size; n++)
-            Funcs::NodeTabBar(g.TabBars.GetByIndex(n));
+        for (int n = 0; n < g.TabBars.Map.Data.Size; n++) // Iterate the map as tab bars may have been removed by GcCompactToMemoryBudget()
+            if (g.TabBars.Map.Data[n].val_i != -1)
+                Funcs::NodeTabBar(g.TabBars.GetByIndex(g.TabBars.Map.Data[n].val_i));
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("Memory"))
+    {
+        const char* category_names[] = { "Windows", "DrawLists", "WindowBuffers", "WindowStorage", "TabBars", "InputText", "Settings", "Misc" }; IM_ASSERT(IM_ARRAYSIZE(category_names) == ImGuiMemoryCategory_COUNT);
+        ImGuiMemoryStats stats;
+        ImGui::GcCalcMemoryStats(&stats);
+        const size_t total_bytes = stats.GetTotal();
+        ImGui::Text("Total: %.1f KB", total_bytes / 1024.0f);
+        if (io.ConfigMemoryCompactBudget > 0)
+            ImGui::Text("Budget: %.1f KB (io.ConfigMemoryCompactBudget)", io.ConfigMemoryCompactBudget / 1024.0f);
+        for (int n = 0; n < ImGuiMemoryCategory_COUNT; n++)
+            ImGui::BulletText("%s: %.1f KB (%.1f%%)", category_names[n], stats.Bytes[n] / 1024.0f, total_bytes > 0 ? 100.0f * stats.Bytes[n] / total_bytes : 0.0f);
+        if (ImGui::Button("Free memory of unused windows and tab bars"))
+            ImGui::GcCompactToMemoryBudget(0);
+        ImGui::TreePop();
+    }
+
+    ImFontAtlas* atlas = g.IO.Fonts;
+    if (ImGui::TreeNode("Font atlas", "Font atlas (%dx%d)", atlas->TexWidth, atlas->TexHeight))
+    {
+        int glyphs_count = 0;
+        for (int font_n = 0; font_n < atlas->Fonts.Size; font_n++)
+            glyphs_count += atlas->Fonts[font_n]->Glyphs.Size;
+        const int tex_surface = atlas->TexWidth * atlas->TexHeight;
+        ImGui::Text("%d fonts, %d glyphs, %d custom rects", atlas->Fonts.Size, glyphs_count, atlas->CustomRects.Size);
+        ImGui::Text("Texture: %dx%d, %.1f KB (Alpha8)", atlas->TexWidth, atlas->TexHeight, tex_surface / 1024.0f);
+        ImGui::Text("Packed: %d pixels, occupancy %.1f%%", atlas->TexPackedSurface, tex_surface > 0 ? 100.0f * atlas->TexPackedSurface / tex_surface : 0.0f);
+        if (atlas->Flags & ImFontAtlasFlags_DynamicGlyphs)
+            ImGui::TextDisabled("(occupancy excludes glyphs rasterized on demand)");
         ImGui::TreePop();
     }
 
@@ -10044,12 +10910,12 @@ void ImGui::ShowMetricsWindow(bool* p_open)
         if (ImGui::Button("Item Picker.."))
             ImGui::DebugStartItemPicker();
 
-        ImGui::Checkbox("Show windows begin order", &show_windows_begin_order);
-        ImGui::Checkbox("Show windows rectangles", &show_windows_rects);
+        ImGui::Checkbox("Show windows begin order", &cfg->ShowWindowsBeginOrder);
+        ImGui::Checkbox("Show windows rectangles", &cfg->ShowWindowsRects);
         ImGui::SameLine();
         ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
-        show_windows_rects |= ImGui::Combo("##show_windows_rect_type", &show_windows_rect_type, wrt_rects_names, WRT_Count);
-        if (show_windows_rects && g.NavWindow)
+        cfg->ShowWindowsRects |= ImGui::Combo("##show_windows_rect_type", &cfg->ShowWindowsRectsType, wrt_rects_names, WRT_Count);
+        if (cfg->ShowWindowsRects && g.NavWindow)
         {
             ImGui::BulletText("'%s':", g.NavWindow->Name);
             ImGui::Indent();
@@ -10060,12 +10926,12 @@ void ImGui::ShowMetricsWindow(bool* p_open)
             }
             ImGui::Unindent();
         }
-        ImGui::Checkbox("Show clipping rectangle when hovering ImDrawCmd node", &show_drawcmd_clip_rects);
+        ImGui::Checkbox("Show clipping rectangle when hovering ImDrawCmd node", &cfg->ShowDrawCmdClipRects);
         ImGui::TreePop();
     }
 
     // Tool: Display windows Rectangles and Begin Order
-    if (show_windows_rects || show_windows_begin_order)
+    if (cfg->ShowWindowsRects || cfg->ShowWindowsBeginOrder)
     {
         for (int n = 0; n < g.Windows.Size; n++)
         {
@@ -10073,12 +10939,12 @@ void ImGui::ShowMetricsWindow(bool* p_open)
             if (!window->WasActive)
                 continue;
             ImDrawList* draw_list = GetForegroundDrawList(window);
-            if (show_windows_rects)
+            if (cfg->ShowWindowsRects)
             {
-                ImRect r = Funcs::GetWindowRect(window, show_windows_rect_type);
+                ImRect r = Funcs::GetWindowRect(window, cfg->ShowWindowsRectsType);
                 draw_list->AddRect(r.Min, r.Max, IM_COL32(255, 0, 128, 255));
             }
-            if (show_windows_begin_order && !(window->Flags & ImGuiWindowFlags_ChildWindow))
+            if (cfg->ShowWindowsBeginOrder && !(window->Flags & ImGuiWindowFlags_ChildWindow))
             {
                 char buf[32];
                 ImFormatString(buf, IM_ARRAYSIZE(buf), "%d", window->BeginOrderWithinContext);
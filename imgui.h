@@ -19,7 +19,7 @@ Index of this file:
 // ImGuiIO
 // Misc data structures (ImGuiInputTextCallbackData, ImGuiSizeCallbackData, ImGuiPayload)
 // Obsolete functions
-// Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiStorage, ImGuiListClipper, ImColor)
+// Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiStorage, ImGuiListClipper, ImGuiTextView, ImColor)
 // Draw List API (ImDrawCallback, ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawListFlags, ImDrawList, ImDrawData)
 // Font API (ImFontConfig, ImFontGlyph, ImFontGlyphRangesBuilder, ImFontAtlasFlags, ImFontAtlas, ImFont)
 
@@ -79,6 +79,12 @@ Index of this file:
 #else
 #define IM_OFFSETOF(_TYPE,_MEMBER)  ((size_t)&(((_TYPE*)0)->_MEMBER))           // Offset of _MEMBER within _TYPE. Old style macro.
 #endif
+#define IM_UNICODE_CODEPOINT_INVALID 0xFFFD                                     // Invalid Unicode code point (standard value).
+#ifdef IMGUI_USE_WCHAR32
+#define IM_UNICODE_CODEPOINT_MAX     0x10FFFF                                   // Maximum Unicode code point supported by this build.
+#else
+#define IM_UNICODE_CODEPOINT_MAX     0xFFFF                                     // Maximum Unicode code point supported by this build.
+#endif
 
 // Warnings
 #if defined(__clang__)
@@ -108,6 +114,7 @@ struct ImFont;                      // Runtime data for a single font within a p
 struct ImFontAtlas;                 // Runtime data for multiple fonts, bake multiple fonts into a single texture, TTF/OTF font loader
 struct ImFontConfig;                // Configuration data when adding a font or merging fonts
 struct ImFontGlyph;                 // A single font glyph (code point + coordinates within in ImFontAtlas + offset)
+struct ImFontKerningPair;           // Advance adjustment between two glyphs, baked when ImFontConfig::Kerning is set
 struct ImFontGlyphRangesBuilder;    // Helper to build glyph ranges from text/string data
 struct ImColor;                     // Helper functions to create a color that can be converted to either u32 or float4 (*OBSOLETE* please avoid using)
 struct ImGuiContext;                // Dear ImGui context (opaque structure, unless including imgui_internal.h)
@@ -121,6 +128,7 @@ struct ImGuiStorage;                // Helper for key->value storage
 struct ImGuiStyle;                  // Runtime data for styling/colors
 struct ImGuiTextBuffer;             // Helper to hold and append into a text buffer (~string builder)
 struct ImGuiTextFilter;             // Helper to parse and apply text filters (e.g. "aaaaa[,bbbb][,ccccc]")
+struct ImGuiTextView;               // Helper to display a large read-only text (e.g. logs) with selection and search highlighting
 
 // Typedefs and Enums/Flags (declared as int for compatibility with old C++, to allow using as flags and to not pollute the top of this file)
 // Use your programming IDE "Go to definition" facility on the names of the center columns to find the actual flags/enum lists.
@@ -128,7 +136,13 @@ struct ImGuiTextFilter;             // Helper to parse and apply text filters (e
 typedef void* ImTextureID;          // User data to identify a texture (this is whatever to you want it to be! read the FAQ about ImTextureID in imgui.cpp)
 #endif
 typedef unsigned int ImGuiID;       // Unique ID used by widgets (typically hashed from a stack of string)
-typedef unsigned short ImWchar;     // A single U16 character for keyboard input/display. We encode them as multi bytes UTF-8 when used in strings.
+typedef unsigned short ImWchar16;   // A single decoded U16 character/code point for keyboard input/display. We encode them as multi bytes UTF-8 when used in strings.
+typedef unsigned int ImWchar32;     // A single decoded U32 character/code point for keyboard input/display. We encode them as multi bytes UTF-8 when used in strings.
+#ifdef IMGUI_USE_WCHAR32            // ImWchar [configurable type: override in imconfig.h with '#define IMGUI_USE_WCHAR32' to support Unicode planes 1-16]
+typedef ImWchar32 ImWchar;
+#else
+typedef ImWchar16 ImWchar;
+#endif
 typedef int ImGuiCol;               // -> enum ImGuiCol_             // Enum: A color identifier for styling
 typedef int ImGuiCond;              // -> enum ImGuiCond_            // Enum: A condition for many Set*() functions
 typedef int ImGuiDataType;          // -> enum ImGuiDataType_        // Enum: A primary data type
@@ -689,9 +703,11 @@ namespace ImGui
     // Settings/.Ini Utilities
     // - The disk functions are automatically called if io.IniFilename != NULL (default is "imgui.ini").
     // - Set io.IniFilename to NULL to load/save manually. Read io.WantSaveIniSettings description about handling .ini saving manually.
+    // - To avoid stalling on slow file systems: read the .ini file from a worker thread started early, and call LoadIniSettingsFromMemory() with its data before the first NewFrame()
+    //   (NewFrame() won't load io.IniFilename again). Set io.WriteIniFileFn to hand over writes to a worker thread.
     IMGUI_API void          LoadIniSettingsFromDisk(const char* ini_filename);                  // call after CreateContext() and before the first call to NewFrame(). NewFrame() automatically calls LoadIniSettingsFromDisk(io.IniFilename).
     IMGUI_API void          LoadIniSettingsFromMemory(const char* ini_data, size_t ini_size=0); // call after CreateContext() and before the first call to NewFrame() to provide .ini data from your own data source.
-    IMGUI_API void          SaveIniSettingsToDisk(const char* ini_filename);                    // this is automatically called (if io.IniFilename is not empty) a few seconds after any modification that should be reflected in the .ini file (and also by DestroyContext).
+    IMGUI_API void          SaveIniSettingsToDisk(const char* ini_filename);                    // this is automatically called (if io.IniFilename is not empty) a few seconds after any modification that should be reflected in the .ini file (and also by DestroyContext). The data is passed to io.WriteIniFileFn.
     IMGUI_API const char*   SaveIniSettingsToMemory(size_t* out_ini_size = NULL);               // return a zero-terminated string with the .ini data which you can save by your own mean. call when io.WantSaveIniSettings is set, then save data by your own mean and clear io.WantSaveIniSettings.
 
     // Memory Allocators
@@ -1366,9 +1382,11 @@ struct ImGuiIO
     bool        MouseDrawCursor;                // = false          // Request ImGui to draw a mouse cursor for you (if you are on a platform without a mouse cursor). Cannot be easily renamed to 'io.ConfigXXX' because this is frequently used by back-end implementations.
     bool        ConfigMacOSXBehaviors;          // = defined(__APPLE__) // OS X style: Text editing cursor movement using Alt instead of Ctrl, Shortcuts using Cmd/Super instead of Ctrl, Line/Text Start and End using Cmd+Arrows instead of Home/End, Double click selects by word instead of selecting whole text, Multi-selection in lists uses Cmd/Super instead of Ctrl (was called io.OptMacOSXBehaviors prior to 1.63)
     bool        ConfigInputTextCursorBlink;     // = true           // Set to false to disable blinking cursor, for users who consider it distracting. (was called: io.OptCursorBlink prior to 1.63)
+    size_t      ConfigInputTextUndoBudget;      // = 1024*1024      // Budget in bytes for the undo/redo history of the active text input. Oldest changes are discarded first. Set to 0 to disable undo.
     bool        ConfigWindowsResizeFromEdges;   // = true           // Enable resizing of windows from their edges and from the lower-left corner. This requires (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors) because it needs mouse cursor feedback. (This used to be a per-window ImGuiWindowFlags_ResizeFromAnySide flag)
     bool        ConfigWindowsMoveFromTitleBarOnly; // = false       // [BETA] Set to true to only allow moving windows when clicked+dragged from the title bar. Windows without a title bar are not affected.
     float       ConfigWindowsMemoryCompactTimer;// = 60.0f          // [BETA] Compact window memory usage when unused. Set to -1.0f to disable.
+    size_t      ConfigMemoryCompactBudget;      // = 0              // [BETA] Budget in bytes for memory owned by the context. When exceeded, state of least recently used windows and tab bars is discarded. See Metrics window. Set to 0 to disable.
 
     //------------------------------------------------------------------
     // Platform Functions
@@ -1388,6 +1406,12 @@ struct ImGuiIO
     void        (*SetClipboardTextFn)(void* user_data, const char* text);
     void*       ClipboardUserData;
 
+    // Optional: Write .ini file data, called by SaveIniSettingsToDisk()
+    // (default to writing a temporary file on the calling thread then renaming it over 'filename', so an interrupted write never leaves a truncated file behind)
+    // Override e.g. to hand the write to a worker thread. 'data' is only valid during the call, make a copy of it.
+    void        (*WriteIniFileFn)(void* user_data, const char* filename, const char* data, size_t data_size);
+    void*       IniUserData;
+
     // Optional: Notify OS Input Method Editor of the screen position of your cursor for text input position (e.g. when using Japanese/Chinese IME on Windows)
     // (default to use native imm32 api on Windows)
     void        (*ImeSetInputScreenPosFn)(int x, int y);
@@ -1419,6 +1443,7 @@ struct ImGuiIO
 
     // Functions
     IMGUI_API void  AddInputCharacter(unsigned int c);          // Queue new character input
+    IMGUI_API void  AddInputCharacterUTF16(ImWchar16 c);        // Queue new character input from an UTF-16 character, it can be a surrogate
     IMGUI_API void  AddInputCharactersUTF8(const char* str);    // Queue new characters input from an UTF-8 string
     IMGUI_API void  ClearInputCharacters();                     // Clear the text input buffer manually
 
@@ -1461,6 +1486,7 @@ struct ImGuiIO
     float       KeysDownDurationPrev[512];      // Previous duration the key has been down
     float       NavInputsDownDuration[ImGuiNavInput_COUNT];
     float       NavInputsDownDurationPrev[ImGuiNavInput_COUNT];
+    ImWchar16   InputQueueSurrogate;            // For AddInputCharacterUTF16
     ImVector<ImWchar> InputQueueCharacters;     // Queue of _characters_ input (obtained by platform back-end). Fill using AddInputCharacter() helper.
 
     IMGUI_API   ImGuiIO();
@@ -1601,8 +1627,10 @@ struct ImGuiTextFilter
     IMGUI_API           ImGuiTextFilter(const char* default_filter = "");
     IMGUI_API bool      Draw(const char* label = "Filter (inc,-exc)", float width = 0.0f);  // Helper calling InputText+Build
     IMGUI_API bool      PassFilter(const char* text, const char* text_end = NULL) const;
+    IMGUI_API bool      PassFilterCached(int line_n, const char* text, const char* text_end = NULL);  // Same as PassFilter() for the line_n-th line of a text, caching the result between frames (e.g. a log only appended to). Call ClearCache() when lines are modified.
     IMGUI_API void      Build();
     void                Clear()          { InputBuf[0] = 0; Build(); }
+    void                ClearCache()     { CacheTested.resize(0); CachePassed.resize(0); }
     bool                IsActive() const { return !Filters.empty(); }
 
     // [Internal]
@@ -1619,6 +1647,9 @@ struct ImGuiTextFilter
     char                    InputBuf[256];
     ImVector<ImGuiTextRange>Filters;
     int                     CountGrep;
+    ImVector<char>          InputBufLower;  // Copy of InputBuf at the time of Build() with ASCII letters in lowercase, Filters point into it
+    ImVector<ImU32>         CacheTested;    // 1 bit per line: result of PassFilterCached() is known
+    ImVector<ImU32>         CachePassed;    // 1 bit per line: result of PassFilterCached()
 };
 
 // Helper: Growable text buffer for logging/accumulating text
@@ -1723,6 +1754,38 @@ struct ImGuiListClipper
     IMGUI_API void End();                                               // Automatically called on the last call of Step() that returns false.
 };
 
+// Helper: Read-only view of a large text (e.g. a log or a memory-mapped file), with selection, copy and search highlighting.
+// The text is not copied. An index of lines is maintained so only visible lines are processed, as with ImGuiListClipper.
+// Usage:
+//     static ImGuiTextView view;
+//     view.SetText(log.begin(), log.end());    // Every frame. The text may move in memory between frames but should only grow by appending.
+//     view.Draw("##log");
+// - The index and search matches are updated incrementally as the text grows. Call Clear() if the text was modified otherwise.
+// - Mouse: click and drag to select, Shift+Click to extend the selection, double-click to select a word. Keyboard: Ctrl+A, Ctrl+C.
+struct ImGuiTextView
+{
+    IMGUI_API           ImGuiTextView();
+    IMGUI_API void      SetText(const char* text, const char* text_end);    // Text doesn't need to be zero-terminated
+    IMGUI_API void      SetSearch(const char* search);                      // Highlight occurrences of 'search' (case sensitive), NULL or "" to disable. Matches are found in steps of a few MB per SetText() call.
+    IMGUI_API void      Draw(const char* str_id, const ImVec2& size = ImVec2(0,0));
+    IMGUI_API void      CopySelectionToClipboard() const;
+    IMGUI_API void      Clear();                                            // Forget the text, its index, selection and search matches
+    bool                HasSelection() const    { return SelectionStart != SelectionEnd; }
+    int                 GetLineCount() const    { return LineOffsets.Size; }
+
+    const char*         Text;                   // Text being viewed (not owned, not zero-terminated)
+    int                 TextSize;
+    int                 SelectionStart;         // Selection (in bytes), SelectionStart is where the mouse was clicked
+    int                 SelectionEnd;
+    bool                AutoScroll;             // = true // Keep scrolling to the bottom as text is appended, when the view was scrolled to the bottom
+
+    // [Internal]
+    ImVector<int>       LineOffsets;            // Offset of the start of each line
+    ImVector<char>      Search;                 // Search string, zero-terminated
+    ImVector<int>       SearchMatches;          // Offset of each occurrence of the search string, in increasing order
+    int                 SearchedSize;           // Number of bytes of Text searched for occurrences
+};
+
 // Helpers macros to generate 32-bits encoded colors
 #ifdef IMGUI_USE_BGRA_PACKED_COLOR
 #define IM_COL32_R_SHIFT    16
@@ -2009,6 +2072,7 @@ struct ImFontConfig
     int             OversampleH;            // 3        // Rasterize at higher quality for sub-pixel positioning. Read https://github.com/nothings/stb/blob/master/tests/oversample/README.md for details.
     int             OversampleV;            // 1        // Rasterize at higher quality for sub-pixel positioning. We don't use sub-pixel positions on the Y axis.
     bool            PixelSnapH;             // false    // Align every glyph to pixel boundary. Useful e.g. if you are merging a non-pixel aligned font with the default font. If enabled, you can set OversampleH/V to 1.
+    bool            Kerning;                // false    // Bake kerning pairs at build time and apply them when measuring and rendering text. Only pairs between the first 256 glyphs of this input (in code point order, e.g. Basic Latin + Latin-1) are baked.
     ImVec2          GlyphExtraSpacing;      // 0, 0     // Extra spacing (in pixels) between glyphs. Only X axis is supported for now.
     ImVec2          GlyphOffset;            // 0, 0     // Offset all glyphs from this font input.
     const ImWchar*  GlyphRanges;            // NULL     // Pointer to a user-provided list of Unicode range (2 value per range, values are inclusive, zero-terminated list). THE ARRAY DATA NEEDS TO PERSIST AS LONG AS THE FONT IS ALIVE.
@@ -2028,22 +2092,32 @@ struct ImFontConfig
 
 struct ImFontGlyph
 {
-    ImWchar         Codepoint;          // 0x0000..0xFFFF
+    unsigned int    Codepoint : 30;     // 0x0000..IM_UNICODE_CODEPOINT_MAX
+    unsigned int    Dynamic : 1;        // Flag to indicate glyph is rasterized on demand by the dynamic glyph cache (see ImFontAtlasFlags_DynamicGlyphs)
+    unsigned int    Rasterized : 1;     // Flag to indicate glyph pixels are present in the texture. Always set for glyphs baked by Build(). X0..V1 are all zero while unset.
     float           AdvanceX;           // Distance to next character (= data from font + ImFontConfig::GlyphExtraSpacing.x baked in)
     float           X0, Y0, X1, Y1;     // Glyph corners
     float           U0, V0, U1, V1;     // Texture coordinates
 };
 
+// Kerning pair (see ImFontConfig::Kerning). Stored in the ImFont::KerningPairs[] hash table.
+struct ImFontKerningPair
+{
+    ImWchar         Left;               // Code point of the first character. 0 for unused slots of the table.
+    ImWchar         Right;              // Code point of the second character
+    float           AdvanceX;           // Adjustment to add to the advance of the first character when followed by the second one (usually negative)
+};
+
 // Helper to build glyph ranges from text/string data. Feed your application strings/characters to it then call BuildRanges().
-// This is essentially a tightly packed of vector of 64k booleans = 8KB storage.
+// This is essentially a tightly packed of vector of booleans, grown by blocks of 64k booleans = 8KB storage up to the highest code point added.
 struct ImFontGlyphRangesBuilder
 {
     ImVector<ImU32> UsedChars;            // Store 1-bit per Unicode code point (0=unused, 1=used)
 
     ImFontGlyphRangesBuilder()          { Clear(); }
-    inline void     Clear()             { int size_in_bytes = 0x10000 / 8; UsedChars.resize(size_in_bytes / (int)sizeof(ImU32)); memset(UsedChars.Data, 0, (size_t)size_in_bytes); }
-    inline bool     GetBit(int n) const { int off = (n >> 5); ImU32 mask = 1u << (n & 31); return (UsedChars[off] & mask) != 0; }  // Get bit n in the array
-    inline void     SetBit(int n)       { int off = (n >> 5); ImU32 mask = 1u << (n & 31); UsedChars[off] |= mask; }               // Set bit n in the array
+    inline void     Clear()             { UsedChars.resize(0); }
+    inline bool     GetBit(int n) const { int off = (n >> 5); ImU32 mask = 1u << (n & 31); return off < UsedChars.Size && (UsedChars[off] & mask) != 0; }  // Get bit n in the array
+    inline void     SetBit(int n)       { int off = (n >> 5); ImU32 mask = 1u << (n & 31); if (off >= UsedChars.Size) UsedChars.resize((off + 2048) & ~2047, 0); UsedChars[off] |= mask; } // Set bit n in the array
     inline void     AddChar(ImWchar c)  { SetBit(c); }                          // Add character
     IMGUI_API void  AddText(const char* text, const char* text_end = NULL);     // Add string (each character of the UTF-8 string are added)
     IMGUI_API void  AddRanges(const ImWchar* ranges);                           // Add ranges, e.g. builder.AddRanges(ImFontAtlas::GetGlyphRangesDefault()) to force add all of ASCII/Latin+Ext
@@ -2053,12 +2127,12 @@ struct ImFontGlyphRangesBuilder
 // See ImFontAtlas::AddCustomRectXXX functions.
 struct ImFontAtlasCustomRect
 {
-    unsigned int    ID;             // Input    // User ID. Use <0x10000 to map into a font glyph, >=0x10000 for other/internal/custom texture data.
+    unsigned int    ID;             // Input    // User ID. Use <=IM_UNICODE_CODEPOINT_MAX to map into a font glyph, >IM_UNICODE_CODEPOINT_MAX for other/internal/custom texture data.
     unsigned short  Width, Height;  // Input    // Desired rectangle dimension
     unsigned short  X, Y;           // Output   // Packed position in Atlas
-    float           GlyphAdvanceX;  // Input    // For custom font glyphs only (ID<0x10000): glyph xadvance
-    ImVec2          GlyphOffset;    // Input    // For custom font glyphs only (ID<0x10000): glyph display offset
-    ImFont*         Font;           // Input    // For custom font glyphs only (ID<0x10000): target font
+    float           GlyphAdvanceX;  // Input    // For custom font glyphs only: glyph xadvance
+    ImVec2          GlyphOffset;    // Input    // For custom font glyphs only: glyph display offset
+    ImFont*         Font;           // Input    // For custom font glyphs only: target font
     ImFontAtlasCustomRect()         { ID = 0xFFFFFFFF; Width = Height = 0; X = Y = 0xFFFF; GlyphAdvanceX = 0.0f; GlyphOffset = ImVec2(0,0); Font = NULL; }
     bool IsPacked() const           { return X != 0xFFFF; }
 };
@@ -2067,9 +2141,14 @@ enum ImFontAtlasFlags_
 {
     ImFontAtlasFlags_None               = 0,
     ImFontAtlasFlags_NoPowerOfTwoHeight = 1 << 0,   // Don't round the height to next power of two
-    ImFontAtlasFlags_NoMouseCursors     = 1 << 1    // Don't build software mouse cursors into the atlas
+    ImFontAtlasFlags_NoMouseCursors     = 1 << 1,   // Don't build software mouse cursors into the atlas
+    ImFontAtlasFlags_DynamicGlyphs      = 1 << 2,   // Only bake ASCII glyphs in Build(), other glyphs of GlyphRanges are rasterized on first use and evicted when the texture is full (least recently used first). Requires the renderer back-end to upload TexDirtyRects every frame. Keep TTF data alive (don't call ClearInputData/ClearTexData) and don't share the atlas between threads. Cleared by the FreeType builder, which doesn't support it.
+    ImFontAtlasFlags_SDF                = 1 << 3,   // Bake glyphs as signed distance fields (edge at value 128). Bake a single size and scale it at runtime with ImFont::Scale/SetWindowFontScale() while staying crisp. Requires the renderer back-end to threshold the alpha of the font texture (see ImGui_ImplOpenGL3). OversampleH/OversampleV and RasterizerMultiply are ignored.
+    ImFontAtlasFlags_CompressBC4        = 1 << 4    // Hint for renderer back-ends: upload the texture block-compressed with GetTexDataAsBC4() when the GPU supports it (4 bits per texel, lossy). Ignored with ImFontAtlasFlags_DynamicGlyphs. Keeps the texture height a multiple of 4.
 };
 
+struct ImFontAtlasDynamicData;      // Opaque storage for ImFontAtlasFlags_DynamicGlyphs (packer state, source fonts)
+
 // Load and rasterize multiple TTF/OTF fonts into a same texture. The font atlas will build a single texture holding:
 //  - One or more fonts.
 //  - Custom graphics data needed to render the shapes needed by Dear ImGui.
@@ -2107,12 +2186,25 @@ struct ImFontAtlas
     // The pitch is always = Width * BytesPerPixels (1 or 4)
     // Building in RGBA32 format is provided for convenience and compatibility, but note that unless you manually manipulate or copy color data into
     // the texture (e.g. when using the AddCustomRect*** api), then the RGB pixels emitted will always be white (~75% of memory/bandwidth waste.
+    // Prefer uploading the Alpha8 data into a single channel texture, swizzled or expanded to (1,1,1,alpha) by your shader, as most of our renderer back-ends do.
     IMGUI_API bool              Build();                    // Build pixels data. This is called automatically for you by the GetTexData*** functions.
     IMGUI_API void              GetTexDataAsAlpha8(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 1 byte per-pixel
     IMGUI_API void              GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 4 bytes-per-pixel
+    IMGUI_API void              GetTexDataAsBC4(unsigned char** out_blocks, int* out_width, int* out_height, int* out_size = NULL);                 // 8 bytes per block of 4x4 texels (BC4_UNORM = RGTC1 red channel), rows of Width/4 blocks. Width and height need to be multiples of 4 (see ImFontAtlasFlags_CompressBC4).
     bool                        IsBuilt()                   { return Fonts.Size > 0 && (TexPixelsAlpha8 != NULL || TexPixelsRGBA32 != NULL); }
     void                        SetTexID(ImTextureID id)    { TexID = id; }
 
+    // [BETA] Build cache: save the fully built atlas (texture + glyphs tables) into a binary blob, and load it back on the next run instead of calling Build().
+    // After adding the same fonts, LoadBuildCacheFromMemory() returns false if the blob doesn't match any of the inputs (font data, ImFontConfig, glyph ranges, custom rectangles...) or this version of the library.
+    // In which case you should call Build() and save a new blob. The blob is flat and can be read from a memory-mapped file. See misc/fonts/README.txt.
+    IMGUI_API bool              SaveBuildCacheToMemory(ImVector<unsigned char>* out_data);
+    IMGUI_API bool              LoadBuildCacheFromMemory(const void* data, size_t data_size);
+
+    // With ImFontAtlasFlags_DynamicGlyphs, glyphs are rasterized into the texture during the frame.
+    // Before rendering, the back-end needs to upload the texels within each of TexDirtyRects (from the same pixel buffer it uploaded initially) then call ClearTexDirtyRects().
+    bool                        HasTexUpdates() const       { return TexDirtyRects.Size > 0; }
+    void                        ClearTexDirtyRects()        { TexDirtyRects.resize(0); }
+
     //-------------------------------------------
     // Glyph Ranges
     //-------------------------------------------
@@ -2138,8 +2230,8 @@ struct ImFontAtlas
     // You can also request your rectangles to be mapped as font glyph (given a font + Unicode point),
     // so you can render e.g. custom colorful icons and use them as regular glyphs.
     // Read misc/fonts/README.txt for more details about using colorful icons.
-    IMGUI_API int               AddCustomRectRegular(unsigned int id, int width, int height);                                                                   // Id needs to be >= 0x10000. Id >= 0x80000000 are reserved for ImGui and ImDrawList
-    IMGUI_API int               AddCustomRectFontGlyph(ImFont* font, ImWchar id, int width, int height, float advance_x, const ImVec2& offset = ImVec2(0,0));   // Id needs to be < 0x10000 to register a rectangle to map into a specific font.
+    IMGUI_API int               AddCustomRectRegular(unsigned int id, int width, int height);                                                                   // Id needs to be > IM_UNICODE_CODEPOINT_MAX (0xFFFF or 0x10FFFF). Id >= 0x80000000 are reserved for ImGui and ImDrawList
+    IMGUI_API int               AddCustomRectFontGlyph(ImFont* font, ImWchar id, int width, int height, float advance_x, const ImVec2& offset = ImVec2(0,0));   // Id needs to be <= IM_UNICODE_CODEPOINT_MAX to register a rectangle to map into a specific font.
     const ImFontAtlasCustomRect*GetCustomRectByIndex(int index) const { if (index < 0) return NULL; return &CustomRects[index]; }
 
     // [Internal]
@@ -2150,20 +2242,31 @@ struct ImFontAtlas
     // Members
     //-------------------------------------------
 
-    bool                        Locked;             // Marked as Locked by ImGui::NewFrame() so attempt to modify the atlas will assert.
+    bool                        Locked;             // Marked as Locked by ImGui::NewFrame() so attempt to modify the atlas will assert. Set to true yourself after building an atlas shared by contexts running on different threads: NewFrame()/EndFrame() will then leave it untouched.
     ImFontAtlasFlags            Flags;              // Build flags (see ImFontAtlasFlags_)
     ImTextureID                 TexID;              // User data to refer to the texture once it has been uploaded to user's graphic systems. It is passed back to you during rendering via the ImDrawCmd structure.
-    int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
+    int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height. Leave to 0 to let Build() try multiple widths and keep the smallest texture.
     int                         TexGlyphPadding;    // Padding between glyphs within texture in pixels. Defaults to 1. If your rendering method doesn't rely on bilinear filtering you may set this to 0.
+    int                         TexSdfSpread;       // Distance in pixels covered by the distance field on each side of glyph edges with ImFontAtlasFlags_SDF. Defaults to 4. Larger values allow more downscaling and effects (e.g. outlines) but use more texture space.
+
+    // [BETA] Optional: rasterize glyphs on multiple threads during Build(). Your function needs to call 'job_func(job_arg, n)' once for each n in [0..job_count) in any order
+    // and on any thread (e.g. dispatch to your job system), and return once all calls are completed. The output is identical to a single-threaded build.
+    // Memory is allocated from the worker threads with the functions passed to ImGui::SetAllocatorFunctions() (without going through the context), so they need to be thread-safe. The default ones (malloc/free) are.
+    void                        (*BuildParallelForFn)(void* user_data, int job_count, void (*job_func)(void* job_arg, int job_index), void* job_arg);
+    void*                       BuildParallelForUserData;
 
     // [Internal]
     // NB: Access texture data via GetTexData*() calls! Which will setup a default font for you.
     unsigned char*              TexPixelsAlpha8;    // 1 component per pixel, each component is unsigned 8-bit. Total size = TexWidth * TexHeight
     unsigned int*               TexPixelsRGBA32;    // 4 component per pixel, each component is unsigned 8-bit. Total size = TexWidth * TexHeight * 4
+    unsigned char*              TexPixelsBC4;       // 8 bytes per block of 4x4 pixels, alpha stored in the red channel. Total size = TexWidth * TexHeight / 2
     int                         TexWidth;           // Texture width calculated during Build().
     int                         TexHeight;          // Texture height calculated during Build().
+    int                         TexPackedSurface;   // Surface of the rectangles packed during Build() (glyphs and custom rectangles, including padding). Compare to TexWidth*TexHeight for occupancy.
     ImVec2                      TexUvScale;         // = (1.0f/TexWidth, 1.0f/TexHeight)
     ImVec2                      TexUvWhitePixel;    // Texture coordinates to a white pixel
+    ImVector<ImVec4>            TexDirtyRects;      // Texel rectangles (x0, y0, x1, y1) modified since the texture was last uploaded. Only used with ImFontAtlasFlags_DynamicGlyphs.
+    ImFontAtlasDynamicData*     DynamicData;        // Persistent build state for ImFontAtlasFlags_DynamicGlyphs, NULL otherwise.
     ImVector<ImFont*>           Fonts;              // Hold all the fonts returned by AddFont*. Fonts[0] is the default font upon calling ImGui::NewFrame(), use ImGui::PushFont()/PopFont() to change the current font.
     ImVector<ImFontAtlasCustomRect> CustomRects;    // Rectangles for packing custom texture data into the atlas.
     ImVector<ImFontConfig>      ConfigData;         // Internal data
@@ -2179,13 +2282,19 @@ struct ImFontAtlas
 // ImFontAtlas automatically loads a default embedded font for you when you call GetTexDataAsAlpha8() or GetTexDataAsRGBA32().
 struct ImFont
 {
-    // Members: Hot ~20/24 bytes (for CalcTextSize)
-    ImVector<float>             IndexAdvanceX;      // 12-16 // out //            // Sparse. Glyphs->AdvanceX in a directly indexable way (cache-friendly for CalcTextSize functions which only this this info, and are often bottleneck in large UI).
+    // Members: Hot ~60/76 bytes (for CalcTextSize)
+    // Codepoints are indexed in two levels: IndexPages[c >> 8] is the page holding the 256 entries of 'c' in IndexAdvanceX[]/IndexLookup[] (see GetIndexSlot).
+    // Pages are only allocated for blocks of codepoints which have glyphs, other blocks share the empty page 0. So a few high codepoints don't cost a full flat table.
+    ImVector<ImU16>             IndexPages;         // 12-16 // out //            // Page number for each block of 256 codepoints.
+    ImVector<float>             IndexAdvanceX;      // 12-16 // out //            // Paged. Glyphs->AdvanceX in a directly indexable way (cache-friendly for CalcTextSize functions which only this this info, and are often bottleneck in large UI).
     float                       FallbackAdvanceX;   // 4     // out // = FallbackGlyph->AdvanceX
     float                       FontSize;           // 4     // in  //            // Height of characters/line, set during loading (don't change after loading)
+    ImVector<ImU8>              KerningClasses;     // 12-16 // out //            // Kerning class of code points 0..255 as the left character of a pair [0..255], and as the right character [256..511]. Class 0 never kerns.
+    ImVector<float>             KerningClassAdvanceX;// 12-16 // out //           // Kerning between code points 0..255, indexed by [left_class * KerningClassesRightCount + right_class]. Derived from KerningPairs[] by BuildLookupTable().
+    int                         KerningClassesRightCount; // 4 // out //
 
     // Members: Hot ~36/48 bytes (for CalcTextSize + render loop)
-    ImVector<ImWchar>           IndexLookup;        // 12-16 // out //            // Sparse. Index glyphs by Unicode code-point.
+    ImVector<ImU16>             IndexLookup;        // 12-16 // out //            // Paged. Index glyphs by Unicode code-point.
     ImVector<ImFontGlyph>       Glyphs;             // 12-16 // out //            // All glyphs.
     const ImFontGlyph*          FallbackGlyph;      // 4-8   // out // = FindGlyph(FontFallbackChar)
     ImVec2                      DisplayOffset;      // 8     // in  // = (0,0)    // Offset font rendering by xx pixels
@@ -2200,14 +2309,20 @@ struct ImFont
     float                       Ascent, Descent;    // 4+4   // out //            // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize]
     int                         MetricsTotalSurface;// 4     // out //            // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
     bool                        DirtyLookupTables;  // 1     // out //
+    ImVector<ImFontKerningPair> KerningPairs;       // 12-16 // out //            // Open-addressing hash table of all kerning pairs (see AddKerningPair). Empty unless built with ImFontConfig::Kerning.
+    int                         KerningPairsCount;  // 4     // out //            // Number of used slots in KerningPairs[]
+    ImVector<int>               GlyphsLastUsedFrame;// 12-16 // out //            // ImFontAtlasFlags_DynamicGlyphs only: atlas frame count of the last FindGlyph() for each glyph, for LRU eviction.
 
     // Methods
     IMGUI_API ImFont();
     IMGUI_API ~ImFont();
-    IMGUI_API const ImFontGlyph*FindGlyph(ImWchar c) const;
-    IMGUI_API const ImFontGlyph*FindGlyphNoFallback(ImWchar c) const;
-    float                       GetCharAdvance(ImWchar c) const     { return ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX[(int)c] : FallbackAdvanceX; }
+    IMGUI_API const ImFontGlyph*FindGlyph(ImWchar c) const;             // Rasterize the glyph if it is missing from a dynamic atlas (ImFontAtlasFlags_DynamicGlyphs)
+    IMGUI_API const ImFontGlyph*FindGlyphNoFallback(ImWchar c) const;   // Query only, never rasterize: check glyph->Rasterized when using a dynamic atlas
+    float                       GetCharAdvance(ImWchar c) const     { const int slot = GetIndexSlot(c); return (slot >= 0) ? IndexAdvanceX.Data[slot] : FallbackAdvanceX; }
+    int                         GetIndexSlot(unsigned int c) const  { const unsigned int page = c >> 8; return (page < (unsigned int)IndexPages.Size) ? ((int)IndexPages.Data[page] << 8) + (int)(c & 0xFF) : -1; } // Index into IndexAdvanceX[]/IndexLookup[], -1 if out of the table
+    float                       GetKerningAdvance(ImWchar left, ImWchar right) const { if ((left | right) < 256) return KerningClassAdvanceX.Size ? KerningClassAdvanceX.Data[KerningClasses.Data[left] * KerningClassesRightCount + KerningClasses.Data[256 + right]] : 0.0f; return KerningPairsCount ? FindKerningPairAdvance(left, right) : 0.0f; } // Adjustment of the advance of 'left' when followed by 'right', 0.0f if none
     bool                        IsLoaded() const                    { return ContainerAtlas != NULL; }
+    IMGUI_API bool              IsGlyphRangeUnused(unsigned int c_begin, unsigned int c_last) const; // Fast check using the page table, doesn't look at individual glyphs
     const char*                 GetDebugName() const                { return ConfigData ? ConfigData->Name : "<unknown>"; }
 
     // 'max_width' stops rendering after a certain width (could be turned into a 2d size). FLT_MAX to disable.
@@ -2219,9 +2334,13 @@ struct ImFont
 
     // [Internal] Don't use!
     IMGUI_API void              BuildLookupTable();
+    IMGUI_API void              BuildKerningClasses();
     IMGUI_API void              ClearOutputData();
     IMGUI_API void              GrowIndex(int new_size);
+    IMGUI_API int               AllocIndexSlot(ImWchar c);
     IMGUI_API void              AddGlyph(ImWchar c, float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float advance_x);
+    IMGUI_API void              AddKerningPair(ImWchar left, ImWchar right, float advance_x); // Needs BuildLookupTable() to be called afterwards
+    IMGUI_API float             FindKerningPairAdvance(ImWchar left, ImWchar right) const;   // Lookup in KerningPairs[], use GetKerningAdvance()
     IMGUI_API void              AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst = true); // Makes 'dst' character/glyph points to 'src' character/glyph. Currently needs to be called AFTER fonts have been built.
     IMGUI_API void              SetFallbackChar(ImWchar c);
 
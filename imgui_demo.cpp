@@ -1060,6 +1060,33 @@ static void ShowDemoWindowWidgets()
             ImGui::TreePop();
         }
 
+        if (ImGui::TreeNode("Read-only Text View"))
+        {
+            // ImGuiTextView displays a large text it doesn't own (e.g. a log), only processing visible lines.
+            // Call SetText() every frame, the line index and search matches are updated as the text grows.
+            static ImGuiTextBuffer log;
+            static ImGuiTextView view;
+            static char search[64] = "";
+            if (ImGui::Button("Add 100000 lines"))
+                for (int n = 0, line_n = log.size(); n < 100000; n++)
+                    log.appendf("[%08X] Hello, line %d, time %.1f, %s\n", line_n + n, n, ImGui::GetTime(), (n % 3) ? "some text" : "more text");
+            ImGui::SameLine();
+            if (ImGui::Button("Clear"))
+            {
+                log.clear();
+                view.Clear();
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Auto-scroll", &view.AutoScroll);
+            ImGui::SetNextItemWidth(200);
+            ImGui::InputText("Search", search, IM_ARRAYSIZE(search));
+            view.SetSearch(search);
+            view.SetText(log.begin(), log.end());
+            ImGui::Text("%d lines, %d bytes, %d matches, selection %d..%d", view.GetLineCount(), view.TextSize, view.SearchMatches.Size, view.SelectionStart, view.SelectionEnd);
+            view.Draw("##TextView", ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 16));
+            ImGui::TreePop();
+        }
+
         ImGui::TreePop();
     }
 
@@ -3082,6 +3109,7 @@ void ImGui::ShowAboutWindow(bool* p_open)
         if (io.ConfigWindowsResizeFromEdges)                            ImGui::Text("io.ConfigWindowsResizeFromEdges");
         if (io.ConfigWindowsMoveFromTitleBarOnly)                       ImGui::Text("io.ConfigWindowsMoveFromTitleBarOnly");
         if (io.ConfigWindowsMemoryCompactTimer >= 0.0f)                 ImGui::Text("io.ConfigWindowsMemoryCompactTimer = %.1ff", io.ConfigWindowsMemoryCompactTimer);
+        if (io.ConfigMemoryCompactBudget > 0)                           ImGui::Text("io.ConfigMemoryCompactBudget = %u", (unsigned int)io.ConfigMemoryCompactBudget);
         ImGui::Text("io.BackendFlags: 0x%08X", io.BackendFlags);
         if (io.BackendFlags & ImGuiBackendFlags_HasGamepad)             ImGui::Text(" HasGamepad");
         if (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors)        ImGui::Text(" HasMouseCursors");
@@ -3325,14 +3353,24 @@ void ImGui::ShowStyleEditor(ImGuiStyle* ref)
                     ImGui::Text("Ellipsis character: '%c' (U+%04X)", font->EllipsisChar, font->EllipsisChar);
                     const float surface_sqrt = sqrtf((float)font->MetricsTotalSurface);
                     ImGui::Text("Texture surface: %d pixels (approx) ~ %dx%d", font->MetricsTotalSurface, (int)surface_sqrt, (int)surface_sqrt);
+                    ImGui::Text("Kerning pairs: %d", font->KerningPairsCount);
                     for (int config_i = 0; config_i < font->ConfigDataCount; config_i++)
                         if (const ImFontConfig* cfg = &font->ConfigData[config_i])
-                            ImGui::BulletText("Input %d: \'%s\', Oversample: (%d,%d), PixelSnapH: %d", config_i, cfg->Name, cfg->OversampleH, cfg->OversampleV, cfg->PixelSnapH);
+                            ImGui::BulletText("Input %d: \'%s\', Oversample: (%d,%d), PixelSnapH: %d, Kerning: %d", config_i, cfg->Name, cfg->OversampleH, cfg->OversampleV, cfg->PixelSnapH, cfg->Kerning);
                     if (ImGui::TreeNode("Glyphs", "Glyphs (%d)", font->Glyphs.Size))
                     {
                         // Display all glyphs of the fonts in separate pages of 256 characters
-                        for (int base = 0; base < 0x10000; base += 256)
+                        for (unsigned int base = 0; base <= IM_UNICODE_CODEPOINT_MAX; base += 256)
                         {
+                            // Skip ahead if a large bunch of glyphs are not present in the font (test in chunks of 4k)
+                            // This is only a small optimization to reduce the number of iterations when IM_UNICODE_CODEPOINT_MAX is large.
+                            // (if ImWchar==ImWchar32 we will do at least about 272 queries here)
+                            if (!(base & 4095) && font->IsGlyphRangeUnused(base, base + 4095))
+                            {
+                                base += 4096 - 256;
+                                continue;
+                            }
+
                             int count = 0;
                             for (int n = 0; n < 256; n++)
                                 count += font->FindGlyphNoFallback((ImWchar)(base + n)) ? 1 : 0;
@@ -3862,6 +3900,7 @@ struct ExampleAppLog
         Buf.clear();
         LineOffsets.clear();
         LineOffsets.push_back(0);
+        Filter.ClearCache();
     }
 
     void    AddLog(const char* fmt, ...) IM_FMTARGS(2)
@@ -3918,11 +3957,13 @@ struct ExampleAppLog
             // This is because we don't have a random access on the result on our filter.
             // A real application processing logs with ten of thousands of entries may want to store the result of search/filter.
             // especially if the filtering function is not trivial (e.g. reg-exp).
+            // Here PassFilterCached() remembers the result for each complete line, as they are never modified (Clear() calls Filter.ClearCache()).
             for (int line_no = 0; line_no < LineOffsets.Size; line_no++)
             {
                 const char* line_start = buf + LineOffsets[line_no];
                 const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
-                if (Filter.PassFilter(line_start, line_end))
+                const bool line_complete = (line_no + 1 < LineOffsets.Size);
+                if (line_complete ? Filter.PassFilterCached(line_no, line_start, line_end) : Filter.PassFilter(line_start, line_end))
                     ImGui::TextUnformatted(line_start, line_end);
             }
         }
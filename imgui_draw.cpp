@@ -129,10 +129,14 @@ namespace IMGUI_STB_NAMESPACE
 #endif
 #endif
 
+// Allocator for stb_truetype. 'user_data' is stbtt_fontinfo::userdata, which is NULL unless we are rasterizing in a job (see ImFontBuildAllocator)
+static inline void*    ImFontAtlasBuildStbttAlloc(size_t sz, void* user_data);
+static inline void     ImFontAtlasBuildStbttFree(void* ptr, void* user_data);
+
 #ifndef STB_TRUETYPE_IMPLEMENTATION                         // in case the user already have an implementation in the _same_ compilation unit (e.g. unity builds)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
-#define STBTT_malloc(x,u)   ((void)(u), IM_ALLOC(x))
-#define STBTT_free(x,u)     ((void)(u), IM_FREE(x))
+#define STBTT_malloc(x,u)   ImFontAtlasBuildStbttAlloc(x,u)
+#define STBTT_free(x,u)     ImFontAtlasBuildStbttFree(x,u)
 #define STBTT_assert(x)     IM_ASSERT(x)
 #define STBTT_fmod(x,y)     ImFmod(x,y)
 #define STBTT_sqrt(x)       ImSqrt(x)
@@ -1419,6 +1423,7 @@ ImFontConfig::ImFontConfig()
     OversampleH = 3; // FIXME: 2 may be a better default?
     OversampleV = 1;
     PixelSnapH = false;
+    Kerning = false;
     GlyphExtraSpacing = ImVec2(0.0f, 0.0f);
     GlyphOffset = ImVec2(0.0f, 0.0f);
     GlyphRanges = NULL;
@@ -1485,6 +1490,39 @@ static const ImVec2 FONT_ATLAS_DEFAULT_TEX_CURSOR_DATA[ImGuiMouseCursor_COUNT][3
     { ImVec2(91,0), ImVec2(17,22), ImVec2( 5, 0) }, // ImGuiMouseCursor_Hand
 };
 
+// Persistent build data for ImFontAtlasFlags_DynamicGlyphs.
+// We keep the rectangle packer and the source fonts alive after Build() so that glyphs can be rasterized on demand.
+// The band at the top of the texture holding data baked by Build() (custom rects + ASCII glyphs) is never evicted.
+struct ImFontAtlasDynamicData
+{
+    stbtt_pack_context          PackContext;    // Packer for the dynamic area, pixels/stride point to atlas->TexPixelsAlpha8
+    ImVector<stbtt_fontinfo>    FontInfos;      // One per atlas->ConfigData[] entry (pointing to ImFontConfig::FontData)
+    int                         StaticHeight;   // Height of the band baked by Build()
+    int                         FrameCount;     // Incremented by ImFontAtlasBuildUpdateDynamicGlyphs(), stored in ImFont::GlyphsLastUsedFrame[]
+    int                         FullFrame;      // Last frame where packing failed (we don't attempt to pack more glyphs until the next eviction)
+    int                         SurfaceUsed;    // Texels used by dynamic glyphs, including padding
+    bool                        WantEviction;   // Set when packing failed, eviction will happen in the next ImFontAtlasBuildUpdateDynamicGlyphs() call
+
+    ImFontAtlasDynamicData()    { memset(&PackContext, 0, sizeof(PackContext)); StaticHeight = FrameCount = SurfaceUsed = 0; FullFrame = -1; WantEviction = false; }
+    ~ImFontAtlasDynamicData()   { if (PackContext.pack_info) stbtt_PackEnd(&PackContext); }
+};
+
+// Reference to a rasterized dynamic glyph, used when evicting (C++03 doesn't allow instancing ImVector<> with function-local types)
+struct ImFontDynamicGlyphRef
+{
+    ImFont*     Font;
+    int         GlyphIndex;
+    int         LastUsedFrame;
+};
+
+static void ImFontAtlasDynamicDestroy(ImFontAtlas* atlas)
+{
+    if (atlas->DynamicData)
+        IM_DELETE(atlas->DynamicData);
+    atlas->DynamicData = NULL;
+    atlas->TexDirtyRects.clear();
+}
+
 ImFontAtlas::ImFontAtlas()
 {
     Locked = false;
@@ -1492,12 +1530,18 @@ ImFontAtlas::ImFontAtlas()
     TexID = (ImTextureID)NULL;
     TexDesiredWidth = 0;
     TexGlyphPadding = 1;
+    TexSdfSpread = 4;
 
     TexPixelsAlpha8 = NULL;
     TexPixelsRGBA32 = NULL;
+    TexPixelsBC4 = NULL;
     TexWidth = TexHeight = 0;
+    TexPackedSurface = 0;
     TexUvScale = ImVec2(0.0f, 0.0f);
     TexUvWhitePixel = ImVec2(0.0f, 0.0f);
+    BuildParallelForFn = NULL;
+    BuildParallelForUserData = NULL;
+    DynamicData = NULL;
     for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
         CustomRectIds[n] = -1;
 }
@@ -1511,6 +1555,7 @@ ImFontAtlas::~ImFontAtlas()
 void    ImFontAtlas::ClearInputData()
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImFontAtlasDynamicDestroy(this); // Dynamic glyphs can't be rasterized without the TTF data
     for (int i = 0; i < ConfigData.Size; i++)
         if (ConfigData[i].FontData && ConfigData[i].FontDataOwnedByAtlas)
         {
@@ -1538,8 +1583,12 @@ void    ImFontAtlas::ClearTexData()
         IM_FREE(TexPixelsAlpha8);
     if (TexPixelsRGBA32)
         IM_FREE(TexPixelsRGBA32);
+    if (TexPixelsBC4)
+        IM_FREE(TexPixelsBC4);
     TexPixelsAlpha8 = NULL;
     TexPixelsRGBA32 = NULL;
+    TexPixelsBC4 = NULL;
+    ImFontAtlasDynamicDestroy(this);
 }
 
 void    ImFontAtlas::ClearFonts()
@@ -1597,6 +1646,105 @@ void    ImFontAtlas::GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_wid
     if (out_bytes_per_pixel) *out_bytes_per_pixel = 4;
 }
 
+// Encode a block of 4x4 texels with the BC4 format (also known as RGTC1 or ATI1): two 8-bit endpoints and 16 3-bit indices.
+// We try both modes of the format and keep the one with the smallest error:
+// - endpoint0 > endpoint1: 8 values interpolated between the endpoints.
+// - endpoint0 <= endpoint1: 6 values interpolated between the endpoints, plus exact 0 and 255. This one suits the anti-aliased edges of glyphs well.
+// Palettes are evenly spaced so we can compute the nearest index of each texel directly.
+static void ImFontAtlasEncodeBlockBC4(const unsigned char* src, int src_stride, unsigned char out_block[8])
+{
+    int values[16];
+    int min_v = 255, max_v = 0, min_v_inner = 255, max_v_inner = 0;
+    for (int n = 0; n < 16; n++)
+    {
+        const int v = src[(n >> 2) * src_stride + (n & 3)];
+        values[n] = v;
+        min_v = ImMin(min_v, v);
+        max_v = ImMax(max_v, v);
+        if (v != 0 && v != 255)
+        {
+            min_v_inner = ImMin(min_v_inner, v);
+            max_v_inner = ImMax(max_v_inner, v);
+        }
+    }
+    if (min_v == max_v)
+    {
+        out_block[0] = out_block[1] = (unsigned char)min_v; // All indices at 0
+        memset(out_block + 2, 0, 6);
+        return;
+    }
+    if (min_v_inner > max_v_inner)
+        min_v_inner = max_v_inner = 0;
+
+    // Index of each step from the lower to the higher endpoint, and decoded values for each index
+    static const unsigned char mode0_step_to_index[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+    static const unsigned char mode1_step_to_index[6] = { 0, 2, 3, 4, 5, 1 };
+    int palettes[2][8];
+    palettes[0][0] = max_v;
+    palettes[0][1] = min_v;
+    for (int n = 1; n < 7; n++)
+        palettes[0][n + 1] = ((7 - n) * max_v + n * min_v + 3) / 7;
+    palettes[1][0] = min_v_inner;
+    palettes[1][1] = max_v_inner;
+    for (int n = 1; n < 5; n++)
+        palettes[1][n + 1] = ((5 - n) * min_v_inner + n * max_v_inner + 2) / 5;
+    palettes[1][6] = 0;
+    palettes[1][7] = 255;
+
+    int best_error = INT_MAX;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        const int* palette = palettes[mode];
+        int error = 0;
+        ImU64 indices = 0;
+        for (int n = 0; n < 16; n++)
+        {
+            const int v = values[n];
+            int index;
+            if (mode == 0)
+                index = mode0_step_to_index[((v - min_v) * 14 + (max_v - min_v)) / (2 * (max_v - min_v))];
+            else if (v == 0 || v == 255)
+                index = (v == 0) ? 6 : 7;
+            else
+                index = mode1_step_to_index[(max_v_inner > min_v_inner) ? ((v - min_v_inner) * 10 + (max_v_inner - min_v_inner)) / (2 * (max_v_inner - min_v_inner)) : 0];
+            error += (v - palette[index]) * (v - palette[index]);
+            indices |= (ImU64)index << (n * 3);
+        }
+        if (error >= best_error)
+            continue;
+        best_error = error;
+        out_block[0] = (unsigned char)palette[0];
+        out_block[1] = (unsigned char)palette[1];
+        for (int n = 0; n < 6; n++)
+            out_block[2 + n] = (unsigned char)(indices >> (n * 8));
+    }
+}
+
+void    ImFontAtlas::GetTexDataAsBC4(unsigned char** out_blocks, int* out_width, int* out_height, int* out_size)
+{
+    // Compress on demand. The blocks are not updated by ImFontAtlasFlags_DynamicGlyphs.
+    if (!TexPixelsBC4)
+    {
+        unsigned char* pixels = NULL;
+        GetTexDataAsAlpha8(&pixels, NULL, NULL);
+        IM_ASSERT((TexWidth & 3) == 0 && (TexHeight & 3) == 0 && "BC4 needs a texture size multiple of 4. Set ImFontAtlasFlags_CompressBC4 before building the atlas.");
+        IM_ASSERT(DynamicData == NULL);
+        if (pixels)
+        {
+            TexPixelsBC4 = (unsigned char*)IM_ALLOC((size_t)TexWidth * (size_t)TexHeight / 2);
+            unsigned char* dst = TexPixelsBC4;
+            for (int y = 0; y < TexHeight; y += 4)
+                for (int x = 0; x < TexWidth; x += 4, dst += 8)
+                    ImFontAtlasEncodeBlockBC4(pixels + (size_t)y * TexWidth + x, TexWidth, dst);
+        }
+    }
+
+    *out_blocks = TexPixelsBC4;
+    if (out_width) *out_width = TexWidth;
+    if (out_height) *out_height = TexHeight;
+    if (out_size) *out_size = TexWidth * TexHeight / 2;
+}
+
 ImFont* ImFontAtlas::AddFont(const ImFontConfig* font_cfg)
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
@@ -1725,7 +1873,7 @@ ImFont* ImFontAtlas::AddFontFromMemoryCompressedBase85TTF(const char* compressed
 
 int ImFontAtlas::AddCustomRectRegular(unsigned int id, int width, int height)
 {
-    IM_ASSERT(id >= 0x10000);
+    IM_ASSERT(id > IM_UNICODE_CODEPOINT_MAX);
     IM_ASSERT(width > 0 && width <= 0xFFFF);
     IM_ASSERT(height > 0 && height <= 0xFFFF);
     ImFontAtlasCustomRect r;
@@ -1739,6 +1887,7 @@ int ImFontAtlas::AddCustomRectRegular(unsigned int id, int width, int height)
 int ImFontAtlas::AddCustomRectFontGlyph(ImFont* font, ImWchar id, int width, int height, float advance_x, const ImVec2& offset)
 {
     IM_ASSERT(font != NULL);
+    IM_ASSERT(id <= IM_UNICODE_CODEPOINT_MAX);
     IM_ASSERT(width > 0 && width <= 0xFFFF);
     IM_ASSERT(height > 0 && height <= 0xFFFF);
     ImFontAtlasCustomRect r;
@@ -1788,6 +1937,324 @@ bool    ImFontAtlas::Build()
     return ImFontAtlasBuildWithStbTruetype(this);
 }
 
+//-----------------------------------------------------------------------------
+// Build cache: the fully built state of the atlas is stored in a flat binary blob.
+// - All sections are 8-bytes aligned and referred to by offset from the beginning of the blob, so it can be read
+//   from a memory-mapped file without any parsing. Loading is a handful of memcpy(), no TTF data is touched.
+// - The header stores a hash of all inputs (font data, ImFontConfig fields, glyph ranges, custom rectangles, atlas settings).
+//   LoadBuildCacheFromMemory() returns false when it doesn't match, in which case you should call Build() and save a new blob.
+// - The blob is only meant to be loaded by the same build of the application (same version, structure sizes and endianness).
+//-----------------------------------------------------------------------------
+
+static const ImU32 FONT_ATLAS_CACHE_MAGIC = 0x43464D49; // "IMFC"
+static const ImU32 FONT_ATLAS_CACHE_VERSION = 4;
+
+struct ImFontAtlasCacheHeader
+{
+    ImU32   Magic;
+    ImU32   Version;                // FONT_ATLAS_CACHE_VERSION
+    ImU32   ImGuiVersionNum;        // IMGUI_VERSION_NUM
+    ImU32   StructSizes;            // Mismatch detection for ImWchar, ImFontGlyph and endianness
+    ImU32   InputsHash;             // ImFontAtlasCalcBuildInputsHash()
+    ImU32   DataSize;               // Size of the whole blob
+    int     TexWidth, TexHeight;
+    int     TexPackedSurface;
+    ImVec2  TexUvWhitePixel;
+    int     CustomRectIds[1];
+    int     FontsCount;
+    int     CustomRectsCount;
+    ImU32   TexPixelsOffset;        // unsigned char[TexWidth * TexHeight]
+    ImU32   FontsOffset;            // ImFontAtlasCacheFont[FontsCount]
+    ImU32   CustomRectsOffset;      // ImFontAtlasCacheCustomRect[CustomRectsCount]
+};
+
+struct ImFontAtlasCacheFont
+{
+    float   FontSize;
+    float   Ascent, Descent;
+    float   FallbackAdvanceX;
+    int     MetricsTotalSurface;
+    int     ConfigDataIndex;        // First ImFontConfig in atlas->ConfigData[] for this font
+    int     ConfigDataCount;
+    int     FallbackGlyphIndex;     // -1 if none
+    ImWchar FallbackChar;
+    ImWchar EllipsisChar;
+    int     GlyphsCount;
+    int     IndexPagesCount;
+    int     IndexCount;
+    int     KerningPairsSize;       // Size of the hash table, 0 or a power of two
+    int     KerningPairsCount;
+    ImU32   GlyphsOffset;           // ImFontGlyph[GlyphsCount]
+    ImU32   IndexPagesOffset;       // ImU16[IndexPagesCount]
+    ImU32   IndexAdvanceXOffset;    // float[IndexCount]
+    ImU32   IndexLookupOffset;      // ImU16[IndexCount]
+    ImU32   KerningPairsOffset;     // ImFontKerningPair[KerningPairsSize]
+};
+
+struct ImFontAtlasCacheCustomRect
+{
+    unsigned short  X, Y;
+};
+
+static ImU32 ImFontAtlasCalcBuildInputsHash(ImFontAtlas* atlas)
+{
+    // Hash fields one by one, structures may contain padding
+    ImU32 h = ImHashData(&atlas->Flags, sizeof(atlas->Flags), FONT_ATLAS_CACHE_VERSION);
+    h = ImHashData(&atlas->TexDesiredWidth, sizeof(atlas->TexDesiredWidth), h);
+    h = ImHashData(&atlas->TexGlyphPadding, sizeof(atlas->TexGlyphPadding), h);
+    h = ImHashData(&atlas->TexSdfSpread, sizeof(atlas->TexSdfSpread), h);
+    for (int n = 0; n < atlas->ConfigData.Size; n++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[n];
+        int dst_font_index = atlas->Fonts.index_from_ptr(atlas->Fonts.find(cfg.DstFont));
+        h = ImHashData(cfg.FontData, (size_t)cfg.FontDataSize, h);
+        h = ImHashData(&cfg.FontNo, sizeof(cfg.FontNo), h);
+        h = ImHashData(&cfg.SizePixels, sizeof(cfg.SizePixels), h);
+        h = ImHashData(&cfg.OversampleH, sizeof(cfg.OversampleH), h);
+        h = ImHashData(&cfg.OversampleV, sizeof(cfg.OversampleV), h);
+        h = ImHashData(&cfg.PixelSnapH, sizeof(cfg.PixelSnapH), h);
+        h = ImHashData(&cfg.Kerning, sizeof(cfg.Kerning), h);
+        h = ImHashData(&cfg.GlyphExtraSpacing, sizeof(cfg.GlyphExtraSpacing), h);
+        h = ImHashData(&cfg.GlyphOffset, sizeof(cfg.GlyphOffset), h);
+        if (const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault())
+        {
+            const ImWchar* ranges_end = ranges;
+            while (ranges_end[0] && ranges_end[1])
+                ranges_end += 2;
+            h = ImHashData(ranges, (size_t)(ranges_end - ranges) * sizeof(ImWchar), h);
+        }
+        h = ImHashData(&cfg.GlyphMinAdvanceX, sizeof(cfg.GlyphMinAdvanceX), h);
+        h = ImHashData(&cfg.GlyphMaxAdvanceX, sizeof(cfg.GlyphMaxAdvanceX), h);
+        h = ImHashData(&cfg.MergeMode, sizeof(cfg.MergeMode), h);
+        h = ImHashData(&cfg.RasterizerFlags, sizeof(cfg.RasterizerFlags), h);
+        h = ImHashData(&cfg.RasterizerMultiply, sizeof(cfg.RasterizerMultiply), h);
+        h = ImHashData(&cfg.EllipsisChar, sizeof(cfg.EllipsisChar), h);
+        h = ImHashData(&dst_font_index, sizeof(dst_font_index), h);
+    }
+    for (int n = 0; n < atlas->CustomRects.Size; n++)
+    {
+        const ImFontAtlasCustomRect& r = atlas->CustomRects[n];
+        int font_index = r.Font ? atlas->Fonts.index_from_ptr(atlas->Fonts.find(r.Font)) : -1;
+        h = ImHashData(&r.ID, sizeof(r.ID), h);
+        h = ImHashData(&r.Width, sizeof(r.Width), h);
+        h = ImHashData(&r.Height, sizeof(r.Height), h);
+        h = ImHashData(&r.GlyphAdvanceX, sizeof(r.GlyphAdvanceX), h);
+        h = ImHashData(&r.GlyphOffset, sizeof(r.GlyphOffset), h);
+        h = ImHashData(&font_index, sizeof(font_index), h);
+    }
+    return h;
+}
+
+static ImU32 ImFontAtlasCacheCalcStructSizes()
+{
+    const ImU32 endianness_check = 0x01;
+    return (ImU32)sizeof(ImWchar) | ((ImU32)sizeof(ImFontGlyph) << 8) | ((ImU32)sizeof(ImFontAtlasCacheFont) << 16) | ((ImU32)(*(const unsigned char*)&endianness_check) << 24);
+}
+
+// Append 'size' bytes to a blob, 8-bytes aligned. Return offset.
+static ImU32 ImFontAtlasCacheAppend(ImVector<unsigned char>* buf, const void* data, size_t size)
+{
+    const int offset = (buf->Size + 7) & ~7;
+    buf->resize(offset + (int)size, 0);
+    if (size > 0)
+        memcpy(buf->Data + offset, data, size);
+    return (ImU32)offset;
+}
+
+// Check that 'count' elements of 'elem_size' bytes starting at 'offset' fit in the blob. Written so that negative or huge values can't overflow.
+// Sections are always written 8-bytes aligned (see ImFontAtlasCacheAppend), so we can read them in place.
+static bool ImFontAtlasCacheCheckSection(size_t data_size, ImU32 offset, int count, size_t elem_size)
+{
+    return (offset & 7) == 0 && (size_t)offset <= data_size && count >= 0 && (size_t)count <= (data_size - offset) / elem_size;
+}
+
+// Copy a section validated with ImFontAtlasCacheCheckSection()
+template<typename T>
+static void ImFontAtlasCacheReadSection(ImVector<T>* out, const unsigned char* blob, ImU32 offset, int count)
+{
+    out->resize(count);
+    if (count > 0)
+        memcpy(out->Data, blob + offset, (size_t)out->size_in_bytes());
+}
+
+bool    ImFontAtlas::SaveBuildCacheToMemory(ImVector<unsigned char>* out_data)
+{
+    IM_ASSERT(out_data != NULL);
+    if (!IsBuilt() || TexPixelsAlpha8 == NULL || DynamicData != NULL) // We can't save the state of ImFontAtlasFlags_DynamicGlyphs
+        return false;
+    for (int font_n = 0; font_n < Fonts.Size; font_n++)
+        if (Fonts[font_n]->ContainerAtlas != this || Fonts[font_n]->DirtyLookupTables)
+            return false;
+
+    ImFontAtlasCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    out_data->resize(0);
+    ImFontAtlasCacheAppend(out_data, &header, sizeof(header));
+    header.Magic = FONT_ATLAS_CACHE_MAGIC;
+    header.Version = FONT_ATLAS_CACHE_VERSION;
+    header.ImGuiVersionNum = IMGUI_VERSION_NUM;
+    header.StructSizes = ImFontAtlasCacheCalcStructSizes();
+    header.InputsHash = ImFontAtlasCalcBuildInputsHash(this);
+    header.TexWidth = TexWidth;
+    header.TexHeight = TexHeight;
+    header.TexPackedSurface = TexPackedSurface;
+    header.TexUvWhitePixel = TexUvWhitePixel;
+    for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
+        header.CustomRectIds[n] = CustomRectIds[n];
+    header.FontsCount = Fonts.Size;
+    header.CustomRectsCount = CustomRects.Size;
+    header.TexPixelsOffset = ImFontAtlasCacheAppend(out_data, TexPixelsAlpha8, (size_t)(TexWidth * TexHeight));
+
+    ImVector<ImFontAtlasCacheFont> cache_fonts;
+    cache_fonts.resize(Fonts.Size);
+    for (int font_n = 0; font_n < Fonts.Size; font_n++)
+    {
+        const ImFont* font = Fonts[font_n];
+        ImFontAtlasCacheFont& cache_font = cache_fonts[font_n];
+        memset(&cache_font, 0, sizeof(cache_font));
+        cache_font.FontSize = font->FontSize;
+        cache_font.Ascent = font->Ascent;
+        cache_font.Descent = font->Descent;
+        cache_font.FallbackAdvanceX = font->FallbackAdvanceX;
+        cache_font.MetricsTotalSurface = font->MetricsTotalSurface;
+        cache_font.ConfigDataIndex = font->ConfigData ? (int)(font->ConfigData - ConfigData.Data) : -1;
+        cache_font.ConfigDataCount = font->ConfigDataCount;
+        cache_font.FallbackGlyphIndex = font->FallbackGlyph ? (int)(font->FallbackGlyph - font->Glyphs.Data) : -1;
+        cache_font.FallbackChar = font->FallbackChar;
+        cache_font.EllipsisChar = font->EllipsisChar;
+        cache_font.GlyphsCount = font->Glyphs.Size;
+        cache_font.IndexPagesCount = font->IndexPages.Size;
+        cache_font.IndexCount = font->IndexLookup.Size;
+        cache_font.KerningPairsSize = font->KerningPairs.Size;
+        cache_font.KerningPairsCount = font->KerningPairsCount;
+        cache_font.GlyphsOffset = ImFontAtlasCacheAppend(out_data, font->Glyphs.Data, (size_t)font->Glyphs.size_in_bytes());
+        cache_font.IndexPagesOffset = ImFontAtlasCacheAppend(out_data, font->IndexPages.Data, (size_t)font->IndexPages.size_in_bytes());
+        cache_font.IndexAdvanceXOffset = ImFontAtlasCacheAppend(out_data, font->IndexAdvanceX.Data, (size_t)font->IndexAdvanceX.size_in_bytes());
+        cache_font.IndexLookupOffset = ImFontAtlasCacheAppend(out_data, font->IndexLookup.Data, (size_t)font->IndexLookup.size_in_bytes());
+        cache_font.KerningPairsOffset = ImFontAtlasCacheAppend(out_data, font->KerningPairs.Data, (size_t)font->KerningPairs.size_in_bytes());
+    }
+    header.FontsOffset = ImFontAtlasCacheAppend(out_data, cache_fonts.Data, (size_t)cache_fonts.size_in_bytes());
+
+    ImVector<ImFontAtlasCacheCustomRect> cache_rects;
+    cache_rects.resize(CustomRects.Size);
+    for (int n = 0; n < CustomRects.Size; n++)
+    {
+        cache_rects[n].X = CustomRects[n].X;
+        cache_rects[n].Y = CustomRects[n].Y;
+    }
+    header.CustomRectsOffset = ImFontAtlasCacheAppend(out_data, cache_rects.Data, (size_t)cache_rects.size_in_bytes());
+
+    header.DataSize = (ImU32)out_data->Size;
+    memcpy(out_data->Data, &header, sizeof(header));
+    return true;
+}
+
+bool    ImFontAtlas::LoadBuildCacheFromMemory(const void* data, size_t data_size)
+{
+    IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    if (ConfigData.empty())
+        AddFontDefault();
+    ImFontAtlasBuildRegisterDefaultCustomRects(this);
+
+    // Validate header and sections
+    ImFontAtlasCacheHeader header;
+    if (data == NULL || data_size < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.Magic != FONT_ATLAS_CACHE_MAGIC || header.Version != FONT_ATLAS_CACHE_VERSION || header.ImGuiVersionNum != IMGUI_VERSION_NUM || header.StructSizes != ImFontAtlasCacheCalcStructSizes())
+        return false;
+    if (header.DataSize != data_size || header.FontsCount != Fonts.Size || header.CustomRectsCount != CustomRects.Size)
+        return false;
+    if (header.InputsHash != ImFontAtlasCalcBuildInputsHash(this))
+        return false;
+    const unsigned char* blob = (const unsigned char*)data;
+    if (header.TexWidth <= 0 || header.TexHeight <= 0 || !ImFontAtlasCacheCheckSection(data_size, header.TexPixelsOffset, header.TexHeight, (size_t)header.TexWidth))
+        return false;
+    if (!ImFontAtlasCacheCheckSection(data_size, header.FontsOffset, header.FontsCount, sizeof(ImFontAtlasCacheFont)) || !ImFontAtlasCacheCheckSection(data_size, header.CustomRectsOffset, header.CustomRectsCount, sizeof(ImFontAtlasCacheCustomRect)))
+        return false;
+    const ImFontAtlasCacheFont* cache_fonts = (const ImFontAtlasCacheFont*)(const void*)(blob + header.FontsOffset);
+    for (int font_n = 0; font_n < header.FontsCount; font_n++)
+    {
+        const ImFontAtlasCacheFont& cache_font = cache_fonts[font_n];
+        if (cache_font.ConfigDataIndex < 0 || cache_font.ConfigDataIndex >= ConfigData.Size || cache_font.ConfigDataCount < 0 || cache_font.ConfigDataCount > ConfigData.Size - cache_font.ConfigDataIndex)
+            return false;
+        if (!ImFontAtlasCacheCheckSection(data_size, cache_font.GlyphsOffset, cache_font.GlyphsCount, sizeof(ImFontGlyph)) || cache_font.FallbackGlyphIndex < -1 || cache_font.FallbackGlyphIndex >= cache_font.GlyphsCount)
+            return false;
+        if (!ImFontAtlasCacheCheckSection(data_size, cache_font.IndexPagesOffset, cache_font.IndexPagesCount, sizeof(ImU16)) || (cache_font.IndexCount & 0xFF) != 0)
+            return false;
+        if (!ImFontAtlasCacheCheckSection(data_size, cache_font.IndexAdvanceXOffset, cache_font.IndexCount, sizeof(float)) || !ImFontAtlasCacheCheckSection(data_size, cache_font.IndexLookupOffset, cache_font.IndexCount, sizeof(ImU16)))
+            return false;
+        const ImU16* cache_index_pages = (const ImU16*)(const void*)(blob + cache_font.IndexPagesOffset);
+        for (int page_n = 0; page_n < cache_font.IndexPagesCount; page_n++)
+            if (cache_index_pages[page_n] >= (cache_font.IndexCount >> 8))
+                return false;
+        const ImU16* cache_index_lookup = (const ImU16*)(const void*)(blob + cache_font.IndexLookupOffset);
+        for (int n = 0; n < cache_font.IndexCount; n++)
+            if (cache_index_lookup[n] != (ImU16)-1 && cache_index_lookup[n] >= cache_font.GlyphsCount)
+                return false;
+        if (!ImFontAtlasCacheCheckSection(data_size, cache_font.KerningPairsOffset, cache_font.KerningPairsSize, sizeof(ImFontKerningPair)) || (cache_font.KerningPairsSize & (cache_font.KerningPairsSize - 1)) != 0)
+            return false;
+
+        // Count used slots instead of trusting KerningPairsCount: lookups probe the hash table until they find an unused slot, so it must never be full.
+        const ImFontKerningPair* cache_kerning_pairs = (const ImFontKerningPair*)(const void*)(blob + cache_font.KerningPairsOffset);
+        int kerning_pairs_count = 0;
+        for (int n = 0; n < cache_font.KerningPairsSize; n++)
+            if (cache_kerning_pairs[n].Left != 0)
+                kerning_pairs_count++;
+        if (kerning_pairs_count != cache_font.KerningPairsCount || kerning_pairs_count * 2 > cache_font.KerningPairsSize)
+            return false;
+    }
+
+    // Texture
+    ClearTexData();
+    TexID = (ImTextureID)NULL;
+    TexWidth = header.TexWidth;
+    TexHeight = header.TexHeight;
+    TexPackedSurface = header.TexPackedSurface;
+    TexUvScale = ImVec2(1.0f / TexWidth, 1.0f / TexHeight);
+    TexUvWhitePixel = header.TexUvWhitePixel;
+    TexPixelsAlpha8 = (unsigned char*)IM_ALLOC((size_t)(TexWidth * TexHeight));
+    memcpy(TexPixelsAlpha8, blob + header.TexPixelsOffset, (size_t)(TexWidth * TexHeight));
+
+    // Custom rectangles
+    for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
+        CustomRectIds[n] = header.CustomRectIds[n];
+    const ImFontAtlasCacheCustomRect* cache_rects = (const ImFontAtlasCacheCustomRect*)(const void*)(blob + header.CustomRectsOffset);
+    for (int n = 0; n < CustomRects.Size; n++)
+    {
+        CustomRects[n].X = cache_rects[n].X;
+        CustomRects[n].Y = cache_rects[n].Y;
+    }
+
+    // Fonts
+    for (int font_n = 0; font_n < Fonts.Size; font_n++)
+    {
+        ImFont* font = Fonts[font_n];
+        const ImFontAtlasCacheFont& cache_font = cache_fonts[font_n];
+        font->ClearOutputData();
+        font->FontSize = cache_font.FontSize;
+        font->Ascent = cache_font.Ascent;
+        font->Descent = cache_font.Descent;
+        font->ContainerAtlas = this;
+        font->ConfigData = &ConfigData[cache_font.ConfigDataIndex];
+        font->ConfigDataCount = (short)cache_font.ConfigDataCount;
+        font->FallbackChar = cache_font.FallbackChar;
+        font->EllipsisChar = cache_font.EllipsisChar;
+        ImFontAtlasCacheReadSection(&font->Glyphs, blob, cache_font.GlyphsOffset, cache_font.GlyphsCount);
+        ImFontAtlasCacheReadSection(&font->IndexPages, blob, cache_font.IndexPagesOffset, cache_font.IndexPagesCount);
+        ImFontAtlasCacheReadSection(&font->IndexAdvanceX, blob, cache_font.IndexAdvanceXOffset, cache_font.IndexCount);
+        ImFontAtlasCacheReadSection(&font->IndexLookup, blob, cache_font.IndexLookupOffset, cache_font.IndexCount);
+        ImFontAtlasCacheReadSection(&font->KerningPairs, blob, cache_font.KerningPairsOffset, cache_font.KerningPairsSize);
+        font->KerningPairsCount = cache_font.KerningPairsCount;
+        font->BuildKerningClasses();
+        font->FallbackGlyph = (cache_font.FallbackGlyphIndex >= 0) ? &font->Glyphs[cache_font.FallbackGlyphIndex] : NULL;
+        font->FallbackAdvanceX = cache_font.FallbackAdvanceX;
+        font->MetricsTotalSurface = cache_font.MetricsTotalSurface;
+        font->DirtyLookupTables = false;
+    }
+    return true;
+}
+
 void    ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_brighten_factor)
 {
     for (unsigned int i = 0; i < 256; i++)
@@ -1819,6 +2286,7 @@ struct ImFontBuildSrcData
     int                 GlyphsCount;        // Glyph count (excluding missing glyphs and glyphs already set by an earlier source font)
     ImBoolVector        GlyphsSet;          // Glyph bit map (random access, 1-bit per codepoint. This will be a maximum of 8KB)
     ImVector<int>       GlyphsList;         // Glyph codepoints list (flattened version of GlyphsMap)
+    ImVector<int>       GlyphsDynamicList;  // Glyph codepoints rasterized on demand (ImFontAtlasFlags_DynamicGlyphs)
 };
 
 // Temporary data for one destination ImFont* (multiple source fonts can be merged into one destination ImFont)
@@ -1830,6 +2298,138 @@ struct ImFontBuildDstData
     ImBoolVector        GlyphsSet;          // This is used to resolve collision when multiple sources are merged into a same destination font.
 };
 
+// A batch of glyphs to rasterize, possibly on a worker thread (see ImFontAtlas::BuildParallelForFn)
+struct ImFontBuildRasterizeJob
+{
+    int                 SrcIndex;           // Index into src_tmp_array[]
+    int                 GlyphStart;         // First glyph in src_tmp_array[SrcIndex].GlyphsList[]
+    int                 GlyphCount;
+};
+
+// Allocator used by rasterization jobs, through stbtt_fontinfo::userdata.
+// It calls the allocator functions directly: ImGui::MemAlloc() updates io.MetricsActiveAllocations of the current context, which would be a data race on worker threads.
+struct ImFontBuildAllocator
+{
+    void*   (*AllocFunc)(size_t sz, void* user_data);
+    void    (*FreeFunc)(void* ptr, void* user_data);
+    void*   UserData;
+};
+
+static inline void* ImFontAtlasBuildStbttAlloc(size_t sz, void* user_data)
+{
+    if (const ImFontBuildAllocator* allocator = (const ImFontBuildAllocator*)user_data)
+        return allocator->AllocFunc(sz, allocator->UserData);
+    return IM_ALLOC(sz);
+}
+
+static inline void ImFontAtlasBuildStbttFree(void* ptr, void* user_data)
+{
+    if (const ImFontBuildAllocator* allocator = (const ImFontBuildAllocator*)user_data)
+        allocator->FreeFunc(ptr, allocator->UserData);
+    else
+        IM_FREE(ptr);
+}
+
+struct ImFontBuildRasterizeJobsContext
+{
+    ImFontAtlas*                    Atlas;
+    ImFontBuildAllocator            Allocator;
+    const stbtt_pack_context*       PackContext;
+    ImFontBuildSrcData*             SrcTmpArray;
+    const ImFontBuildRasterizeJob*  Jobs;
+};
+
+// Calculate the size of the rectangle to pack for a glyph (this is based on stbtt_PackFontRangesGatherRects)
+static void ImFontAtlasBuildCalcGlyphRectSize(const ImFontAtlas* atlas, const ImFontConfig& cfg, const stbtt_fontinfo* font_info, float scale, int glyph_index_in_font, stbrp_rect* r)
+{
+    int x0, y0, x1, y1;
+    const int padding = atlas->TexGlyphPadding;
+    if (atlas->Flags & ImFontAtlasFlags_SDF)
+    {
+        // Distance fields are not oversampled, but extend 'TexSdfSpread' pixels beyond the glyph bounding box (same as stbtt_GetGlyphSDF)
+        stbtt_GetGlyphBitmapBoxSubpixel(font_info, glyph_index_in_font, scale, scale, 0, 0, &x0, &y0, &x1, &y1);
+        const int spread = (x0 == x1 || y0 == y1) ? 0 : atlas->TexSdfSpread;
+        r->w = (stbrp_coord)(x1 - x0 + spread * 2 + padding);
+        r->h = (stbrp_coord)(y1 - y0 + spread * 2 + padding);
+        return;
+    }
+    stbtt_GetGlyphBitmapBoxSubpixel(font_info, glyph_index_in_font, scale * cfg.OversampleH, scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
+    r->w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
+    r->h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
+}
+
+// Render a glyph as a signed distance field into its packed rectangle and fill its stbtt_packedchar (this is the ImFontAtlasFlags_SDF equivalent of stbtt_PackFontRangesRenderIntoRects)
+static void ImFontAtlasBuildRenderGlyphSdf(ImFontAtlas* atlas, const stbtt_fontinfo* font_info, float scale, int codepoint, const stbrp_rect* r, stbtt_packedchar* out_packed_char)
+{
+    const int glyph_index_in_font = stbtt_FindGlyphIndex(font_info, codepoint);
+    int advance, lsb;
+    stbtt_GetGlyphHMetrics(font_info, glyph_index_in_font, &advance, &lsb);
+    memset(out_packed_char, 0, sizeof(*out_packed_char));
+    out_packed_char->xadvance = scale * advance;
+    if (!r->was_packed)
+        return;
+
+    const int spread = atlas->TexSdfSpread;
+    int w = 0, h = 0, xoff = 0, yoff = 0;
+    unsigned char* sdf = stbtt_GetGlyphSDF(font_info, scale, glyph_index_in_font, spread, 128, 128.0f / spread, &w, &h, &xoff, &yoff);
+    if (sdf == NULL) // Empty glyph (e.g. space)
+        return;
+    IM_ASSERT(w + atlas->TexGlyphPadding <= r->w && h + atlas->TexGlyphPadding <= r->h);
+    for (int y = 0; y < h; y++)
+        memcpy(atlas->TexPixelsAlpha8 + r->x + (r->y + y) * atlas->TexWidth, sdf + y * w, (size_t)w);
+    stbtt_FreeSDF(sdf, font_info->userdata);
+
+    out_packed_char->x0 = (unsigned short)r->x;
+    out_packed_char->y0 = (unsigned short)r->y;
+    out_packed_char->x1 = (unsigned short)(r->x + w);
+    out_packed_char->y1 = (unsigned short)(r->y + h);
+    out_packed_char->xoff = (float)xoff;
+    out_packed_char->yoff = (float)yoff;
+    out_packed_char->xoff2 = (float)(xoff + w);
+    out_packed_char->yoff2 = (float)(yoff + h);
+}
+
+// Each job writes into its own rectangles of the texture, so the output doesn't depend on the order or thread jobs are executed on.
+static void ImFontAtlasBuildRasterizeJob(void* arg, int job_index)
+{
+    const ImFontBuildRasterizeJobsContext* ctx = (const ImFontBuildRasterizeJobsContext*)arg;
+    const ImFontBuildRasterizeJob& job = ctx->Jobs[job_index];
+    ImFontBuildSrcData& src_tmp = ctx->SrcTmpArray[job.SrcIndex];
+    const ImFontConfig& cfg = ctx->Atlas->ConfigData[job.SrcIndex];
+
+    // Work on a copy of the font info so stb_truetype allocates through our allocator
+    stbtt_fontinfo font_info = src_tmp.FontInfo;
+    font_info.userdata = (void*)&ctx->Allocator;
+
+    if (ctx->Atlas->Flags & ImFontAtlasFlags_SDF)
+    {
+        const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&font_info, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&font_info, -cfg.SizePixels);
+        for (int glyph_i = job.GlyphStart; glyph_i < job.GlyphStart + job.GlyphCount; glyph_i++)
+            ImFontAtlasBuildRenderGlyphSdf(ctx->Atlas, &font_info, scale, src_tmp.GlyphsList[glyph_i], &src_tmp.Rects[glyph_i], &src_tmp.PackedChars[glyph_i]);
+        return;
+    }
+
+    // Work on copies: stbtt_PackFontRangesRenderIntoRects() temporarily modifies the pack context
+    stbtt_pack_context spc = *ctx->PackContext;
+    stbtt_pack_range pack_range = src_tmp.PackRange;
+    pack_range.array_of_unicode_codepoints += job.GlyphStart;
+    pack_range.chardata_for_range += job.GlyphStart;
+    pack_range.num_chars = job.GlyphCount;
+    stbrp_rect* rects = src_tmp.Rects + job.GlyphStart;
+    stbtt_PackFontRangesRenderIntoRects(&spc, &font_info, &pack_range, 1, rects);
+
+    // Apply multiply operator
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        stbrp_rect* r = rects;
+        for (int glyph_i = 0; glyph_i < job.GlyphCount; glyph_i++, r++)
+            if (r->was_packed)
+                ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, ctx->Atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, ctx->Atlas->TexWidth * 1);
+    }
+}
+
 static void UnpackBoolVectorToFlatIndexList(const ImBoolVector* in, ImVector<int>* out)
 {
     IM_ASSERT(sizeof(in->Storage.Data[0]) == sizeof(int));
@@ -1842,15 +2442,19 @@ static void UnpackBoolVectorToFlatIndexList(const ImBoolVector* in, ImVector<int
                     out->push_back((int)((it - it_begin) << 5) + bit_n);
 }
 
+static void ImFontAtlasDynamicResetPacker(ImFontAtlas* atlas);
+
 bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
+    const bool dynamic_glyphs = (atlas->Flags & ImFontAtlasFlags_DynamicGlyphs) != 0;
 
     ImFontAtlasBuildRegisterDefaultCustomRects(atlas);
 
     // Clear atlas
     atlas->TexID = (ImTextureID)NULL;
     atlas->TexWidth = atlas->TexHeight = 0;
+    atlas->TexPackedSurface = 0;
     atlas->TexUvScale = ImVec2(0.0f, 0.0f);
     atlas->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
     atlas->ClearTexData();
@@ -1905,18 +2509,25 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
             dst_tmp.GlyphsSet.Resize(dst_tmp.GlyphsHighest + 1);
 
         for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
-            for (int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
+            for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
             {
                 if (dst_tmp.GlyphsSet.GetBit(codepoint))    // Don't overwrite existing glyphs. We could make this an option for MergeMode (e.g. MergeOverwrite==true)
                     continue;
                 if (!stbtt_FindGlyphIndex(&src_tmp.FontInfo, codepoint))    // It is actually in the font?
                     continue;
 
+                // Only bake ASCII when using a dynamic atlas, other glyphs will be rasterized on demand
+                dst_tmp.GlyphsSet.SetBit(codepoint, true);
+                if (dynamic_glyphs && codepoint >= 0x80)
+                {
+                    src_tmp.GlyphsDynamicList.push_back(codepoint);
+                    continue;
+                }
+
                 // Add to avail set/counters
                 src_tmp.GlyphsCount++;
                 dst_tmp.GlyphsCount++;
                 src_tmp.GlyphsSet.SetBit(codepoint, true);
-                dst_tmp.GlyphsSet.SetBit(codepoint, true);
                 total_glyphs_count++;
             }
     }
@@ -1944,7 +2555,6 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     memset(buf_packedchars.Data, 0, (size_t)buf_packedchars.size_in_bytes());
 
     // 4. Gather glyphs sizes so we can pack them in our virtual canvas.
-    int total_surface = 0;
     int buf_rects_out_n = 0;
     int buf_packedchars_out_n = 0;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
@@ -1968,84 +2578,69 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         src_tmp.PackRange.h_oversample = (unsigned char)cfg.OversampleH;
         src_tmp.PackRange.v_oversample = (unsigned char)cfg.OversampleV;
 
-        // Gather the sizes of all rectangles we will need to pack (this loop is based on stbtt_PackFontRangesGatherRects)
+        // Gather the sizes of all rectangles we will need to pack
         const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
-        const int padding = atlas->TexGlyphPadding;
         for (int glyph_i = 0; glyph_i < src_tmp.GlyphsList.Size; glyph_i++)
         {
-            int x0, y0, x1, y1;
             const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
             IM_ASSERT(glyph_index_in_font != 0);
-            stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, scale * cfg.OversampleH, scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
-            src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
-            src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
-            total_surface += src_tmp.Rects[glyph_i].w * src_tmp.Rects[glyph_i].h;
+            ImFontAtlasBuildCalcGlyphRectSize(atlas, cfg, &src_tmp.FontInfo, scale, glyph_index_in_font, &src_tmp.Rects[glyph_i]);
         }
     }
 
-    // We need a width for the skyline algorithm, any width!
-    // The exact width doesn't really matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
-    // User can override TexDesiredWidth and TexGlyphPadding if they wish, otherwise we use a simple heuristic to select the width based on expected surface.
-    const int surface_sqrt = (int)ImSqrt((float)total_surface) + 1;
-    atlas->TexHeight = 0;
-    if (atlas->TexDesiredWidth > 0)
-        atlas->TexWidth = atlas->TexDesiredWidth;
-    else
-        atlas->TexWidth = (surface_sqrt >= 4096*0.7f) ? 4096 : (surface_sqrt >= 2048*0.7f) ? 2048 : (surface_sqrt >= 1024*0.7f) ? 1024 : 512;
-
-    // 5. Start packing
-    // Pack our extra data rectangles first, so it will be on the upper-left corner of our texture (UV will have small values).
+    // 5-6. Pack our extra data rectangles and the glyphs of all source fonts. No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
+    // User can override TexDesiredWidth and TexGlyphPadding if they wish, otherwise we try multiple widths and keep the one giving the smallest texture.
+    // Glyphs which couldn't be packed are marked as non-packed so we won't render them.
+    ImFontAtlasBuildPackRects(atlas, buf_rects.Data, buf_rects_out_n);
     const int TEX_HEIGHT_MAX = 1024 * 32;
-    stbtt_pack_context spc = {};
+    stbtt_pack_context spc = {};            // Only used for rendering from now on
     stbtt_PackBegin(&spc, NULL, atlas->TexWidth, TEX_HEIGHT_MAX, 0, atlas->TexGlyphPadding, NULL);
-    ImFontAtlasBuildPackCustomRects(atlas, spc.pack_info);
-
-    // 6. Pack each source font. No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
-    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbrp_pack_rects((stbrp_context*)spc.pack_info, src_tmp.Rects, src_tmp.GlyphsCount);
-
-        // Extend texture height and mark missing glyphs as non-packed so we won't render them.
-        // FIXME: We are not handling packing failure here (would happen if we got off TEX_HEIGHT_MAX or if a single if larger than TexWidth?)
-        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
-            if (src_tmp.Rects[glyph_i].was_packed)
-                atlas->TexHeight = ImMax(atlas->TexHeight, src_tmp.Rects[glyph_i].y + src_tmp.Rects[glyph_i].h);
-    }
 
     // 7. Allocate texture
-    atlas->TexHeight = (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight) ? (atlas->TexHeight + 1) : ImUpperPowerOfTwo(atlas->TexHeight);
+    // When using a dynamic atlas, we leave room for glyphs rasterized on demand (the texture is at least square).
+    const int static_height = atlas->TexHeight;
+    atlas->TexHeight = ImFontAtlasBuildCalcTexHeight(atlas, atlas->TexWidth, atlas->TexHeight);
     atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
     atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(atlas->TexWidth * atlas->TexHeight);
     memset(atlas->TexPixelsAlpha8, 0, atlas->TexWidth * atlas->TexHeight);
     spc.pixels = atlas->TexPixelsAlpha8;
     spc.height = atlas->TexHeight;
+    if (dynamic_glyphs)
+    {
+        ImFontAtlasDynamicData* dyn = atlas->DynamicData = IM_NEW(ImFontAtlasDynamicData)();
+        dyn->StaticHeight = static_height;
+        dyn->FontInfos.resize(src_tmp_array.Size);
+        for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+            dyn->FontInfos[src_i] = src_tmp_array[src_i].FontInfo;
+        ImFontAtlasDynamicResetPacker(atlas);
+    }
 
     // 8. Render/rasterize font characters into the texture
+    // Glyphs are split in batches which may be rasterized in parallel, as positions are known at this point.
+    const int GLYPHS_PER_JOB = 64;
+    ImVector<ImFontBuildRasterizeJob> rasterize_jobs;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontConfig& cfg = atlas->ConfigData[src_i];
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbtt_PackFontRangesRenderIntoRects(&spc, &src_tmp.FontInfo, &src_tmp.PackRange, 1, src_tmp.Rects);
-
-        // Apply multiply operator
-        if (cfg.RasterizerMultiply != 1.0f)
+        for (int glyph_start = 0; glyph_start < src_tmp_array[src_i].GlyphsCount; glyph_start += GLYPHS_PER_JOB)
         {
-            unsigned char multiply_table[256];
-            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
-            stbrp_rect* r = &src_tmp.Rects[0];
-            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++, r++)
-                if (r->was_packed)
-                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+            ImFontBuildRasterizeJob job;
+            job.SrcIndex = src_i;
+            job.GlyphStart = glyph_start;
+            job.GlyphCount = ImMin(GLYPHS_PER_JOB, src_tmp_array[src_i].GlyphsCount - glyph_start);
+            rasterize_jobs.push_back(job);
         }
-        src_tmp.Rects = NULL;
-    }
+    ImFontBuildRasterizeJobsContext rasterize_ctx;
+    rasterize_ctx.Atlas = atlas;
+    ImGui::GetAllocatorFunctions(&rasterize_ctx.Allocator.AllocFunc, &rasterize_ctx.Allocator.FreeFunc, &rasterize_ctx.Allocator.UserData);
+    rasterize_ctx.PackContext = &spc;
+    rasterize_ctx.SrcTmpArray = src_tmp_array.Data;
+    rasterize_ctx.Jobs = rasterize_jobs.Data;
+    if (atlas->BuildParallelForFn != NULL && rasterize_jobs.Size > 1)
+        atlas->BuildParallelForFn(atlas->BuildParallelForUserData, rasterize_jobs.Size, ImFontAtlasBuildRasterizeJob, &rasterize_ctx);
+    else
+        for (int job_i = 0; job_i < rasterize_jobs.Size; job_i++)
+            ImFontAtlasBuildRasterizeJob(&rasterize_ctx, job_i);
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+        src_tmp_array[src_i].Rects = NULL;
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -2055,7 +2650,7 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
     {
         ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
+        if (src_tmp.GlyphsCount == 0 && src_tmp.GlyphsDynamicList.Size == 0)
             continue;
 
         ImFontConfig& cfg = atlas->ConfigData[src_i];
@@ -2088,6 +2683,43 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
             stbtt_GetPackedQuad(src_tmp.PackedChars, atlas->TexWidth, atlas->TexHeight, glyph_i, &dummy_x, &dummy_y, &q, 0);
             dst_font->AddGlyph((ImWchar)codepoint, q.x0 + char_off_x, q.y0 + font_off_y, q.x1 + char_off_x, q.y1 + font_off_y, q.s0, q.t0, q.s1, q.t1, char_advance_x_mod);
         }
+
+        // Register glyphs which will be rasterized on demand. We only need their advance for now, so CalcTextSize() is correct before they are rasterized.
+        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsDynamicList.Size; glyph_i++)
+        {
+            int advance, lsb;
+            stbtt_GetCodepointHMetrics(&src_tmp.FontInfo, src_tmp.GlyphsDynamicList[glyph_i], &advance, &lsb);
+            const float char_advance_x_mod = ImClamp(advance * font_scale, cfg.GlyphMinAdvanceX, cfg.GlyphMaxAdvanceX);
+            dst_font->AddGlyph((ImWchar)src_tmp.GlyphsDynamicList[glyph_i], 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, char_advance_x_mod);
+            dst_font->Glyphs.back().Dynamic = 1;
+            dst_font->Glyphs.back().Rasterized = 0;
+        }
+
+        // Bake kerning pairs (from the 'kern' or 'GPOS' tables) between the first glyphs of this input
+        if (cfg.Kerning && (src_tmp.FontInfo.kern || src_tmp.FontInfo.gpos))
+        {
+            ImVector<int> kerning_codepoints;
+            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsList.Size && kerning_codepoints.Size < IM_FONTATLAS_KERNING_GLYPHS_MAX; glyph_i++)
+                kerning_codepoints.push_back(src_tmp.GlyphsList[glyph_i]);
+            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsDynamicList.Size && kerning_codepoints.Size < IM_FONTATLAS_KERNING_GLYPHS_MAX; glyph_i++)
+                kerning_codepoints.push_back(src_tmp.GlyphsDynamicList[glyph_i]);
+            ImVector<int> kerning_glyph_indices;
+            kerning_glyph_indices.resize(kerning_codepoints.Size);
+            for (int n = 0; n < kerning_codepoints.Size; n++)
+                kerning_glyph_indices[n] = stbtt_FindGlyphIndex(&src_tmp.FontInfo, kerning_codepoints[n]);
+
+            const float kerning_scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
+            for (int left_n = 0; left_n < kerning_codepoints.Size; left_n++)
+                for (int right_n = 0; right_n < kerning_codepoints.Size; right_n++)
+                {
+                    const int unscaled_advance = stbtt_GetGlyphKernAdvance(&src_tmp.FontInfo, kerning_glyph_indices[left_n], kerning_glyph_indices[right_n]);
+                    if (unscaled_advance == 0)
+                        continue;
+                    const float advance = cfg.PixelSnapH ? ImFloor(unscaled_advance * kerning_scale + 0.5f) : unscaled_advance * kerning_scale;
+                    if (advance != 0.0f)
+                        dst_font->AddKerningPair((ImWchar)kerning_codepoints[left_n], (ImWchar)kerning_codepoints[right_n], advance);
+                }
+        }
     }
 
     // Cleanup temporary (ImVector doesn't honor destructor)
@@ -2095,6 +2727,9 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         src_tmp_array[src_i].~ImFontBuildSrcData();
 
     ImFontAtlasBuildFinish(atlas);
+    if (dynamic_glyphs)
+        for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+            atlas->Fonts[font_i]->GlyphsLastUsedFrame.resize(atlas->Fonts[font_i]->Glyphs.Size, 0);
     return true;
 }
 
@@ -2149,6 +2784,157 @@ void ImFontAtlasBuildPackCustomRects(ImFontAtlas* atlas, void* stbrp_context_opa
         }
 }
 
+// Texture height for a given packed height, after leaving room for ImFontAtlasFlags_DynamicGlyphs and rounding.
+int ImFontAtlasBuildCalcTexHeight(const ImFontAtlas* atlas, int tex_width, int packed_height)
+{
+    if (atlas->Flags & ImFontAtlasFlags_DynamicGlyphs)
+        packed_height = ImMax(packed_height * 2, tex_width);
+    if (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight)
+        return (atlas->Flags & ImFontAtlasFlags_CompressBC4) ? ((packed_height + 1 + 3) & ~3) : (packed_height + 1);
+    return ImUpperPowerOfTwo(packed_height);
+}
+
+// Pack all rectangles with a given texture width and heuristic. Return false if some of them didn't fit.
+// Custom rectangles are packed first so they end up on the upper-left corner of our texture (UV will have small values).
+static bool ImFontAtlasBuildPackRectsWithWidth(ImFontAtlas* atlas, stbrp_rect* rects, int custom_rects_count, int rects_count, int tex_width, int heuristic, ImVector<stbrp_node>* nodes, int* out_packed_height)
+{
+    // Same setup as stbtt_PackBegin()
+    const int TEX_HEIGHT_MAX = 1024 * 32;
+    const int padding = atlas->TexGlyphPadding;
+    stbrp_context context;
+    nodes->resize(tex_width - padding);
+    stbrp_init_target(&context, tex_width - padding, TEX_HEIGHT_MAX - padding, nodes->Data, nodes->Size);
+    stbrp_setup_heuristic(&context, heuristic);
+    stbrp_pack_rects(&context, rects, custom_rects_count);
+    stbrp_pack_rects(&context, rects + custom_rects_count, rects_count - custom_rects_count);
+
+    bool all_packed = true;
+    int packed_height = 0;
+    for (int i = 0; i < rects_count; i++)
+        if (rects[i].was_packed)
+            packed_height = ImMax(packed_height, rects[i].y + rects[i].h);
+        else
+            all_packed = false;
+    *out_packed_height = packed_height;
+    return all_packed;
+}
+
+// We need a width for the skyline algorithm. Some API/GPU have texture size limitations and increasing width can decrease height,
+// but otherwise the best width depends on the glyphs sizes, and a wrong guess followed by rounding the height to a power of two can easily waste half the texture.
+// So unless TexDesiredWidth is set, we try power-of-two widths from 256 up to the square root of the surface rounded up (plus a few non-power-of-two
+// widths around it when ImFontAtlasFlags_NoPowerOfTwoHeight is set) with both skyline heuristics of stb_rect_pack, and keep the smallest final texture.
+// Widths which can't beat the best texture so far even with a perfect packing are skipped, so in practice we only pack a few times.
+// A texture larger than 4096 in either dimension is only selected when nothing else fits.
+void ImFontAtlasBuildPackRects(ImFontAtlas* atlas, void* stbrp_rects_opaque, int rects_count)
+{
+    stbrp_rect* glyph_rects = (stbrp_rect*)stbrp_rects_opaque;
+    const int TEX_SIZE_SOFT_MAX = 4096;
+    const int padding = atlas->TexGlyphPadding;
+
+    ImVector<ImFontAtlasCustomRect>& user_rects = atlas->CustomRects;
+    IM_ASSERT(user_rects.Size >= 1); // We expect at least the default custom rects to be registered, else something went wrong.
+
+    // Gather all rectangles in a single array (custom rectangles first)
+    ImVector<stbrp_rect> rects;
+    rects.resize(user_rects.Size + rects_count);
+    for (int i = 0; i < user_rects.Size; i++)
+    {
+        memset(&rects[i], 0, sizeof(stbrp_rect));
+        rects[i].w = user_rects[i].Width;
+        rects[i].h = user_rects[i].Height;
+    }
+    if (rects_count > 0)
+        memcpy(&rects[user_rects.Size], glyph_rects, (size_t)rects_count * sizeof(stbrp_rect));
+    int total_surface = 0, max_rect_w = 0, max_rect_h = 0;
+    for (int i = 0; i < rects.Size; i++)
+    {
+        total_surface += rects[i].w * rects[i].h;
+        max_rect_w = ImMax(max_rect_w, (int)rects[i].w);
+        max_rect_h = ImMax(max_rect_h, (int)rects[i].h);
+    }
+
+    // Candidate widths (wider textures than the square root of the surface rounded up to a power of two only make very elongated textures)
+    const int surface_sqrt = (int)ImSqrt((float)total_surface) + 1;
+    ImVector<int> widths;
+    if (atlas->TexDesiredWidth > 0)
+        widths.push_back(atlas->TexDesiredWidth);
+    else if (atlas->Flags & ImFontAtlasFlags_DynamicGlyphs)
+        widths.push_back(1024);
+    else
+    {
+        const int width_max = ImMin(ImUpperPowerOfTwo(ImMax(surface_sqrt, max_rect_w + padding)), TEX_SIZE_SOFT_MAX);
+        for (int w = 256; w == 256 || w <= width_max; w *= 2)
+            widths.push_back(w);
+        if (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight)
+        {
+            const float width_factors[] = { 1.0f, 1.25f, 1.5f };
+            for (int n = 0; n < IM_ARRAYSIZE(width_factors); n++)
+            {
+                const int w = ((int)(surface_sqrt * width_factors[n]) + padding + 63) & ~63;
+                if (w < TEX_SIZE_SOFT_MAX && !ImIsPowerOfTwo(w) && !widths.contains(w))
+                    widths.push_back(w);
+            }
+        }
+    }
+    const int heuristics[] = { STBRP_HEURISTIC_Skyline_BL_sortHeight, STBRP_HEURISTIC_Skyline_BF_sortHeight };
+
+    // Try candidates. Prefer (1) textures within TEX_SIZE_SOFT_MAX (2) the smallest area (3) the smallest largest dimension.
+    // Wider textures generally waste less space on their edges, so we try them first to find a good candidate early and skip more of the other ones.
+    ImVector<stbrp_node> nodes;
+    int best_width = widths.back();
+    int best_heuristic = heuristics[0];
+    int best_area = INT_MAX;
+    int best_size_max = INT_MAX;
+    bool best_oversized = true;
+    for (int width_n = widths.Size - 1; width_n >= 0; width_n--)
+    {
+        const int w = widths[width_n];
+        if (widths.Size > 1 && w - padding < max_rect_w)
+            continue;
+        if (!best_oversized)
+        {
+            const int h_min = ImFontAtlasBuildCalcTexHeight(atlas, w, ImMax(max_rect_h, total_surface / (w - padding)));
+            if (w * h_min > best_area || (w * h_min == best_area && ImMax(w, h_min) >= best_size_max))
+                continue;
+        }
+        for (int heuristic_n = 0; heuristic_n < IM_ARRAYSIZE(heuristics); heuristic_n++)
+        {
+            int packed_height;
+            if (!ImFontAtlasBuildPackRectsWithWidth(atlas, rects.Data, user_rects.Size, rects.Size, w, heuristics[heuristic_n], &nodes, &packed_height))
+                continue;
+            const int h = ImFontAtlasBuildCalcTexHeight(atlas, w, packed_height);
+            const int area = w * h;
+            const int size_max = ImMax(w, h);
+            const bool oversized = size_max > TEX_SIZE_SOFT_MAX;
+            if (oversized != best_oversized ? !oversized : (area < best_area || (area == best_area && size_max < best_size_max)))
+            {
+                best_width = w;
+                best_heuristic = heuristics[heuristic_n];
+                best_area = area;
+                best_size_max = size_max;
+                best_oversized = oversized;
+            }
+        }
+    }
+
+    // Pack again with the selected candidate and output positions.
+    // FIXME: If no candidate could fit everything, we carry on with the rectangles which were packed. Other glyphs won't be rendered.
+    int packed_height = 0;
+    ImFontAtlasBuildPackRectsWithWidth(atlas, rects.Data, user_rects.Size, rects.Size, best_width, best_heuristic, &nodes, &packed_height);
+    for (int i = 0; i < user_rects.Size; i++)
+        if (rects[i].was_packed)
+        {
+            user_rects[i].X = rects[i].x;
+            user_rects[i].Y = rects[i].y;
+            IM_ASSERT(rects[i].w == user_rects[i].Width && rects[i].h == user_rects[i].Height);
+        }
+    if (rects_count > 0)
+        memcpy(glyph_rects, &rects[user_rects.Size], (size_t)rects_count * sizeof(stbrp_rect));
+    atlas->TexWidth = best_width;
+    atlas->TexHeight = packed_height;
+    atlas->TexPackedSurface = total_surface;
+}
+
 static void ImFontAtlasBuildRenderDefaultTexData(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->CustomRectIds[0] >= 0);
@@ -2189,7 +2975,7 @@ void ImFontAtlasBuildFinish(ImFontAtlas* atlas)
     for (int i = 0; i < atlas->CustomRects.Size; i++)
     {
         const ImFontAtlasCustomRect& r = atlas->CustomRects[i];
-        if (r.Font == NULL || r.ID > 0x10000)
+        if (r.Font == NULL || r.ID > IM_UNICODE_CODEPOINT_MAX)
             continue;
 
         IM_ASSERT(r.Font->ContainerAtlas == atlas);
@@ -2221,6 +3007,222 @@ void ImFontAtlasBuildFinish(ImFontAtlas* atlas)
     }
 }
 
+// Restart packing the dynamic area from scratch (after Build() and when evicting glyphs)
+static void ImFontAtlasDynamicResetPacker(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamicData* dyn = atlas->DynamicData;
+    if (dyn->PackContext.pack_info)
+        stbtt_PackEnd(&dyn->PackContext);
+    stbtt_PackBegin(&dyn->PackContext, NULL, atlas->TexWidth, atlas->TexHeight, 0, atlas->TexGlyphPadding, NULL);
+    dyn->PackContext.pixels = atlas->TexPixelsAlpha8; // Set after stbtt_PackBegin() which would clear the texture
+
+    // Reserve the band baked by Build()
+    stbrp_rect r;
+    memset(&r, 0, sizeof(r));
+    r.w = (stbrp_coord)(atlas->TexWidth - atlas->TexGlyphPadding);
+    r.h = (stbrp_coord)dyn->StaticHeight;
+    stbrp_pack_rects((stbrp_context*)dyn->PackContext.pack_info, &r, 1);
+    IM_ASSERT(r.was_packed && r.x == 0 && r.y == 0);
+    dyn->SurfaceUsed = 0;
+    dyn->FullFrame = -1;
+}
+
+static void ImFontAtlasDynamicAddDirtyRect(ImFontAtlas* atlas, int x0, int y0, int x1, int y1)
+{
+    // Merge with the previous rectangle when they overlap vertically (glyphs packed on a same skyline row), to keep the number of uploads low
+    if (atlas->TexDirtyRects.Size > 0)
+    {
+        ImVec4& last = atlas->TexDirtyRects.back();
+        if ((float)y0 <= last.w && (float)y1 >= last.y)
+        {
+            last = ImVec4(ImMin(last.x, (float)x0), ImMin(last.y, (float)y0), ImMax(last.z, (float)x1), ImMax(last.w, (float)y1));
+            return;
+        }
+    }
+    atlas->TexDirtyRects.push_back(ImVec4((float)x0, (float)y0, (float)x1, (float)y1));
+}
+
+static void ImFontAtlasDynamicClearGlyph(ImFontGlyph* glyph)
+{
+    glyph->X0 = glyph->Y0 = glyph->X1 = glyph->Y1 = 0.0f;
+    glyph->U0 = glyph->V0 = glyph->U1 = glyph->V1 = 0.0f;
+    glyph->Rasterized = 0;
+}
+
+// Pack and rasterize a single glyph into the dynamic area. This is the per-glyph equivalent of steps 4 to 9 of ImFontAtlasBuildWithStbTruetype().
+static bool ImFontAtlasDynamicRasterizeGlyph(ImFontAtlas* atlas, ImFont* font, ImFontGlyph* glyph)
+{
+    ImFontAtlasDynamicData* dyn = atlas->DynamicData;
+    IM_ASSERT(glyph->Dynamic && !glyph->Rasterized);
+    if (dyn->FullFrame == dyn->FrameCount)
+        return false;
+
+    // Find the source font providing this codepoint. Like Build(), earlier sources have priority when merging fonts.
+    const int codepoint = (int)glyph->Codepoint;
+    int src_i = -1;
+    int glyph_index_in_font = 0;
+    for (int n = 0; n < atlas->ConfigData.Size && src_i == -1; n++)
+        if (atlas->ConfigData[n].DstFont == font)
+            if ((glyph_index_in_font = stbtt_FindGlyphIndex(&dyn->FontInfos[n], codepoint)) != 0)
+                src_i = n;
+    if (src_i == -1)
+    {
+        glyph->Rasterized = 1; // Nothing to display (e.g. copy of a glyph under another codepoint)
+        return true;
+    }
+
+    const ImFontConfig& cfg = atlas->ConfigData[src_i];
+    const stbtt_fontinfo* font_info = &dyn->FontInfos[src_i];
+    const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(font_info, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(font_info, -cfg.SizePixels);
+    stbrp_rect r;
+    memset(&r, 0, sizeof(r));
+    ImFontAtlasBuildCalcGlyphRectSize(atlas, cfg, font_info, scale, glyph_index_in_font, &r);
+    stbrp_pack_rects((stbrp_context*)dyn->PackContext.pack_info, &r, 1);
+    if (!r.was_packed)
+    {
+        // Texture is full: give up for this frame, the glyph will be invisible until evictions make room for it.
+        dyn->FullFrame = dyn->FrameCount;
+        dyn->WantEviction = true;
+        return false;
+    }
+    const int rect_x0 = r.x, rect_y0 = r.y, rect_x1 = r.x + r.w, rect_y1 = r.y + r.h;
+    dyn->SurfaceUsed += r.w * r.h;
+
+    // Rasterize
+    stbtt_packedchar packed_char;
+    memset(&packed_char, 0, sizeof(packed_char));
+    if (atlas->Flags & ImFontAtlasFlags_SDF)
+    {
+        ImFontAtlasBuildRenderGlyphSdf(atlas, font_info, scale, codepoint, &r, &packed_char);
+    }
+    else
+    {
+        stbtt_pack_range pack_range;
+        memset(&pack_range, 0, sizeof(pack_range));
+        pack_range.font_size = cfg.SizePixels;
+        pack_range.array_of_unicode_codepoints = (int*)&codepoint;
+        pack_range.num_chars = 1;
+        pack_range.chardata_for_range = &packed_char;
+        pack_range.h_oversample = (unsigned char)cfg.OversampleH;
+        pack_range.v_oversample = (unsigned char)cfg.OversampleV;
+        stbtt_PackFontRangesRenderIntoRects(&dyn->PackContext, font_info, &pack_range, 1, &r);
+    }
+    if (cfg.RasterizerMultiply != 1.0f && r.w > 0 && r.h > 0 && !(atlas->Flags & ImFontAtlasFlags_SDF))
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r.x, r.y, r.w, r.h, atlas->TexWidth);
+    }
+    if (atlas->TexPixelsRGBA32)
+        for (int y = rect_y0; y < rect_y1; y++)
+        {
+            const unsigned char* src = atlas->TexPixelsAlpha8 + y * atlas->TexWidth;
+            unsigned int* dst = atlas->TexPixelsRGBA32 + y * atlas->TexWidth;
+            for (int x = rect_x0; x < rect_x1; x++)
+                dst[x] = IM_COL32(255, 255, 255, (unsigned int)src[x]);
+        }
+    ImFontAtlasDynamicAddDirtyRect(atlas, rect_x0, rect_y0, rect_x1, rect_y1);
+
+    // Setup glyph, keeping the AdvanceX computed by Build()
+    const float font_off_x = cfg.GlyphOffset.x;
+    const float font_off_y = cfg.GlyphOffset.y + (float)(int)(font->Ascent + 0.5f);
+    const float char_advance_x_org = packed_char.xadvance;
+    const float char_advance_x_mod = ImClamp(char_advance_x_org, cfg.GlyphMinAdvanceX, cfg.GlyphMaxAdvanceX);
+    float char_off_x = font_off_x;
+    if (char_advance_x_org != char_advance_x_mod)
+        char_off_x += cfg.PixelSnapH ? (float)(int)((char_advance_x_mod - char_advance_x_org) * 0.5f) : (char_advance_x_mod - char_advance_x_org) * 0.5f;
+
+    stbtt_aligned_quad q;
+    float dummy_x = 0.0f, dummy_y = 0.0f;
+    stbtt_GetPackedQuad(&packed_char, atlas->TexWidth, atlas->TexHeight, 0, &dummy_x, &dummy_y, &q, 0);
+    glyph->X0 = q.x0 + char_off_x;
+    glyph->Y0 = q.y0 + font_off_y;
+    glyph->X1 = q.x1 + char_off_x;
+    glyph->Y1 = q.y1 + font_off_y;
+    glyph->U0 = q.s0;
+    glyph->V0 = q.t0;
+    glyph->U1 = q.s1;
+    glyph->V1 = q.t1;
+    glyph->Rasterized = 1;
+    return true;
+}
+
+// Called by ImFont::FindGlyph() on dynamic glyphs.
+static void ImFontAtlasDynamicUseGlyph(ImFontAtlas* atlas, ImFont* font, int glyph_index)
+{
+    ImFontAtlasDynamicData* dyn = atlas->DynamicData;
+    if (dyn == NULL)
+        return;
+    if (glyph_index < font->GlyphsLastUsedFrame.Size)
+        font->GlyphsLastUsedFrame.Data[glyph_index] = dyn->FrameCount;
+    ImFontGlyph* glyph = &font->Glyphs.Data[glyph_index];
+    if (!glyph->Rasterized)
+        ImFontAtlasDynamicRasterizeGlyph(atlas, font, glyph);
+}
+
+static int IMGUI_CDECL ImFontDynamicGlyphRefComparerByLastUsedFrame(const void* lhs, const void* rhs)
+{
+    // Most recently used first
+    const ImFontDynamicGlyphRef* a = (const ImFontDynamicGlyphRef*)lhs;
+    const ImFontDynamicGlyphRef* b = (const ImFontDynamicGlyphRef*)rhs;
+    if (int d = b->LastUsedFrame - a->LastUsedFrame)
+        return d;
+    return (a->GlyphIndex - b->GlyphIndex);
+}
+
+// Called by ImGui::NewFrame(), before any glyph is used during the frame, so we are free to move glyphs around the texture.
+// The skyline packer can't free individual rectangles: when the dynamic area is full we evict everything, then rasterize back
+// the most recently used glyphs until half of the area is used. This amortize the cost of eviction over many newly used glyphs.
+void ImFontAtlasBuildUpdateDynamicGlyphs(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamicData* dyn = atlas->DynamicData;
+    if (dyn == NULL)
+        return;
+    dyn->FrameCount++;
+    if (!dyn->WantEviction)
+        return;
+    dyn->WantEviction = false;
+
+    // Gather rasterized dynamic glyphs and evict all of them
+    ImVector<ImFontDynamicGlyphRef> glyph_refs;
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        if (font->ContainerAtlas != atlas)
+            continue;
+        for (int glyph_i = 0; glyph_i < font->Glyphs.Size; glyph_i++)
+        {
+            ImFontGlyph* glyph = &font->Glyphs[glyph_i];
+            if (!glyph->Dynamic || !glyph->Rasterized)
+                continue;
+            ImFontDynamicGlyphRef ref;
+            ref.Font = font;
+            ref.GlyphIndex = glyph_i;
+            ref.LastUsedFrame = (glyph == font->FallbackGlyph) ? INT_MAX : (glyph_i < font->GlyphsLastUsedFrame.Size) ? font->GlyphsLastUsedFrame[glyph_i] : 0;
+            glyph_refs.push_back(ref);
+            ImFontAtlasDynamicClearGlyph(glyph);
+        }
+    }
+    if (glyph_refs.Size > 1)
+        ImQsort(glyph_refs.Data, (size_t)glyph_refs.Size, sizeof(ImFontDynamicGlyphRef), ImFontDynamicGlyphRefComparerByLastUsedFrame);
+
+    // Clear dynamic area
+    const int dynamic_area_offset = dyn->StaticHeight * atlas->TexWidth;
+    const int dynamic_area_size = (atlas->TexHeight - dyn->StaticHeight) * atlas->TexWidth;
+    memset(atlas->TexPixelsAlpha8 + dynamic_area_offset, 0, (size_t)dynamic_area_size);
+    if (atlas->TexPixelsRGBA32)
+        for (int n = 0; n < dynamic_area_size; n++)
+            atlas->TexPixelsRGBA32[dynamic_area_offset + n] = IM_COL32(255, 255, 255, 0);
+    ImFontAtlasDynamicResetPacker(atlas);
+    ImFontAtlasDynamicAddDirtyRect(atlas, 0, dyn->StaticHeight, atlas->TexWidth, atlas->TexHeight);
+
+    // Rasterize back most recently used glyphs
+    for (int n = 0; n < glyph_refs.Size && dyn->SurfaceUsed < dynamic_area_size / 2; n++)
+        if (!ImFontAtlasDynamicRasterizeGlyph(atlas, glyph_refs[n].Font, &glyph_refs[n].Font->Glyphs[glyph_refs[n].GlyphIndex]))
+            break;
+    dyn->FullFrame = -1;
+}
+
 // Retrieve list of range (2 int per range, values are inclusive)
 const ImWchar*   ImFontAtlas::GetGlyphRangesDefault()
 {
@@ -2453,22 +3455,27 @@ void ImFontGlyphRangesBuilder::AddText(const char* text, const char* text_end)
         text += c_len;
         if (c_len == 0)
             break;
-        if (c < 0x10000)
-            AddChar((ImWchar)c);
+        AddChar((ImWchar)c);
     }
 }
 
 void ImFontGlyphRangesBuilder::AddRanges(const ImWchar* ranges)
 {
     for (; ranges[0]; ranges += 2)
-        for (ImWchar c = ranges[0]; c <= ranges[1]; c++)
-            AddChar(c);
+        for (unsigned int c = ranges[0]; c <= ranges[1]; c++) // Not using ImWchar as loop variable, as ranges[1] may be its maximum value
+            AddChar((ImWchar)c);
 }
 
 void ImFontGlyphRangesBuilder::BuildRanges(ImVector<ImWchar>* out_ranges)
 {
-    int max_codepoint = 0x10000;
+    const int max_codepoint = UsedChars.Size * 32;
     for (int n = 0; n < max_codepoint; n++)
+    {
+        if (UsedChars[n >> 5] == 0) // Skip empty blocks of 32 code points
+        {
+            n |= 31;
+            continue;
+        }
         if (GetBit(n))
         {
             out_ranges->push_back((ImWchar)n);
@@ -2476,6 +3483,7 @@ void ImFontGlyphRangesBuilder::BuildRanges(ImVector<ImWchar>* out_ranges)
                 n++;
             out_ranges->push_back((ImWchar)n);
         }
+    }
     out_ranges->push_back(0);
 }
 
@@ -2495,6 +3503,8 @@ ImFont::ImFont()
     ConfigData = NULL;
     ConfigDataCount = 0;
     DirtyLookupTables = false;
+    KerningClassesRightCount = 0;
+    KerningPairsCount = 0;
     Scale = 1.0f;
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
@@ -2510,8 +3520,15 @@ void    ImFont::ClearOutputData()
     FontSize = 0.0f;
     FallbackAdvanceX = 0.0f;
     Glyphs.clear();
+    IndexPages.clear();
     IndexAdvanceX.clear();
     IndexLookup.clear();
+    KerningClasses.clear();
+    KerningClassAdvanceX.clear();
+    KerningClassesRightCount = 0;
+    KerningPairs.clear();
+    KerningPairsCount = 0;
+    GlyphsLastUsedFrame.clear();
     FallbackGlyph = NULL;
     ContainerAtlas = NULL;
     DirtyLookupTables = true;
@@ -2526,15 +3543,16 @@ void ImFont::BuildLookupTable()
         max_codepoint = ImMax(max_codepoint, (int)Glyphs[i].Codepoint);
 
     IM_ASSERT(Glyphs.Size < 0xFFFF); // -1 is reserved
+    IndexPages.clear();
     IndexAdvanceX.clear();
     IndexLookup.clear();
     DirtyLookupTables = false;
     GrowIndex(max_codepoint + 1);
     for (int i = 0; i < Glyphs.Size; i++)
     {
-        int codepoint = (int)Glyphs[i].Codepoint;
-        IndexAdvanceX[codepoint] = Glyphs[i].AdvanceX;
-        IndexLookup[codepoint] = (ImWchar)i;
+        const int slot = AllocIndexSlot((ImWchar)Glyphs[i].Codepoint);
+        IndexAdvanceX[slot] = Glyphs[i].AdvanceX;
+        IndexLookup[slot] = (ImU16)i;
     }
 
     // Create a glyph to handle TAB
@@ -2547,15 +3565,21 @@ void ImFont::BuildLookupTable()
         tab_glyph = *FindGlyph((ImWchar)' ');
         tab_glyph.Codepoint = '\t';
         tab_glyph.AdvanceX *= IM_TABSIZE;
-        IndexAdvanceX[(int)tab_glyph.Codepoint] = (float)tab_glyph.AdvanceX;
-        IndexLookup[(int)tab_glyph.Codepoint] = (ImWchar)(Glyphs.Size-1);
+        const int slot = AllocIndexSlot((ImWchar)'\t');
+        IndexAdvanceX[slot] = (float)tab_glyph.AdvanceX;
+        IndexLookup[slot] = (ImU16)(Glyphs.Size-1);
     }
 
     FallbackGlyph = FindGlyphNoFallback(FallbackChar);
     FallbackAdvanceX = FallbackGlyph ? FallbackGlyph->AdvanceX : 0.0f;
-    for (int i = 0; i < max_codepoint + 1; i++)
+    if (FallbackGlyph && FallbackGlyph->Dynamic)
+        FindGlyph(FallbackChar); // FallbackGlyph is used directly so we need it to be rasterized
+
+    for (int i = 0; i < IndexAdvanceX.Size; i++) // Including the empty page 0
         if (IndexAdvanceX[i] < 0.0f)
             IndexAdvanceX[i] = FallbackAdvanceX;
+
+    BuildKerningClasses();
 }
 
 void ImFont::SetFallbackChar(ImWchar c)
@@ -2564,13 +3588,37 @@ void ImFont::SetFallbackChar(ImWchar c)
     BuildLookupTable();
 }
 
+// Grow the page table to cover codepoints [0..new_size). Pages themselves are allocated by AllocIndexSlot().
 void ImFont::GrowIndex(int new_size)
 {
     IM_ASSERT(IndexAdvanceX.Size == IndexLookup.Size);
-    if (new_size <= IndexLookup.Size)
-        return;
-    IndexAdvanceX.resize(new_size, -1.0f);
-    IndexLookup.resize(new_size, (ImWchar)-1);
+    if (IndexLookup.Size == 0)
+    {
+        // Page 0 is shared by all blocks of codepoints without glyphs, and never written to
+        IndexAdvanceX.resize(256, -1.0f);
+        IndexLookup.resize(256, (ImU16)-1);
+    }
+    const int new_pages_count = (new_size + 255) >> 8;
+    if (new_pages_count > IndexPages.Size)
+        IndexPages.resize(new_pages_count, 0);
+}
+
+// Return the index of 'c' into IndexAdvanceX[]/IndexLookup[] for writing, allocating its page if needed.
+// A new page is a copy of the empty page, so its other entries keep pointing to the fallback glyph.
+int ImFont::AllocIndexSlot(ImWchar c)
+{
+    GrowIndex((int)c + 1);
+    ImU16& page = IndexPages[(int)c >> 8];
+    if (page == 0)
+    {
+        IM_ASSERT((IndexLookup.Size >> 8) <= 0xFFFF);
+        page = (ImU16)(IndexLookup.Size >> 8);
+        IndexAdvanceX.resize(IndexAdvanceX.Size + 256);
+        IndexLookup.resize(IndexLookup.Size + 256);
+        memcpy(&IndexAdvanceX[(int)page << 8], &IndexAdvanceX[0], 256 * sizeof(float));
+        memcpy(&IndexLookup[(int)page << 8], &IndexLookup[0], 256 * sizeof(ImU16));
+    }
+    return ((int)page << 8) + ((int)c & 0xFF);
 }
 
 // x0/y0/x1/y1 are offset from the character upper-left layout position, in pixels. Therefore x0/y0 are often fairly close to zero.
@@ -2580,6 +3628,8 @@ void ImFont::AddGlyph(ImWchar codepoint, float x0, float y0, float x1, float y1,
     Glyphs.resize(Glyphs.Size + 1);
     ImFontGlyph& glyph = Glyphs.back();
     glyph.Codepoint = (ImWchar)codepoint;
+    glyph.Dynamic = 0;
+    glyph.Rasterized = 1;
     glyph.X0 = x0;
     glyph.Y0 = y0;
     glyph.X1 = x1;
@@ -2598,37 +3648,174 @@ void ImFont::AddGlyph(ImWchar codepoint, float x0, float y0, float x1, float y1,
     MetricsTotalSurface += (int)((glyph.U1 - glyph.U0) * ContainerAtlas->TexWidth + 1.99f) * (int)((glyph.V1 - glyph.V0) * ContainerAtlas->TexHeight + 1.99f);
 }
 
+static inline unsigned int ImFontKerningHash(unsigned int left, unsigned int right)
+{
+    unsigned int h = left * 0x9E3779B1u + right;
+    h ^= h >> 15;
+    h *= 0x85EBCA6Bu;
+    return h ^ (h >> 13);
+}
+
+// Kerning pairs are stored in an open-addressing hash table with linear probing, which we keep at most half full.
+// Most pairs of characters have no kerning, so lookups of missing pairs need to stop early on an empty slot.
+void ImFont::AddKerningPair(ImWchar left, ImWchar right, float advance_x)
+{
+    IM_ASSERT(left != 0 && right != 0);
+    if ((KerningPairsCount + 1) * 2 > KerningPairs.Size)
+    {
+        ImVector<ImFontKerningPair> old_pairs;
+        old_pairs.swap(KerningPairs);
+        ImFontKerningPair empty_pair;
+        memset(&empty_pair, 0, sizeof(empty_pair));
+        KerningPairs.resize(ImMax(old_pairs.Size * 2, 64), empty_pair);
+        KerningPairsCount = 0;
+        for (int n = 0; n < old_pairs.Size; n++)
+            if (old_pairs[n].Left != 0)
+                AddKerningPair(old_pairs[n].Left, old_pairs[n].Right, old_pairs[n].AdvanceX);
+    }
+
+    const unsigned int mask = (unsigned int)KerningPairs.Size - 1;
+    for (unsigned int i = ImFontKerningHash(left, right) & mask; ; i = (i + 1) & mask)
+    {
+        ImFontKerningPair& pair = KerningPairs.Data[i];
+        if (pair.Left == 0)
+        {
+            pair.Left = left;
+            pair.Right = right;
+            KerningPairsCount++;
+        }
+        else if (pair.Left != left || pair.Right != right)
+        {
+            continue;
+        }
+        pair.AdvanceX = advance_x;
+        DirtyLookupTables = true;
+        return;
+    }
+}
+
+float ImFont::FindKerningPairAdvance(ImWchar left, ImWchar right) const
+{
+    if (KerningPairs.Size == 0)
+        return 0.0f;
+    const unsigned int mask = (unsigned int)KerningPairs.Size - 1;
+    for (unsigned int i = ImFontKerningHash(left, right) & mask; ; i = (i + 1) & mask)
+    {
+        const ImFontKerningPair& pair = KerningPairs.Data[i];
+        if (pair.Left == left && pair.Right == right)
+            return pair.AdvanceX;
+        if (pair.Left == 0)
+            return 0.0f;
+    }
+}
+
+// Assign a class to each of the 256 vectors { table[n * n_stride + k * k_stride], k = 0..255 }, identical vectors sharing the same class.
+// Class 0 is for vectors of zeros. Output the index of the first vector of each class. Return the number of classes (at most 256, as code point 0 never kerns).
+static int ImFontKerningCalcClasses(const float* table, int n_stride, int k_stride, ImU8* out_classes, int* out_class_first)
+{
+    int classes_count = 1;
+    out_class_first[0] = 0;
+    for (int n = 0; n < 256; n++)
+    {
+        const float* v = table + n * n_stride;
+        int k = 0;
+        while (k < 256 && v[k * k_stride] == 0.0f)
+            k++;
+        int class_n = 0;
+        if (k < 256)
+            for (class_n = 1; class_n < classes_count; class_n++)
+            {
+                const float* v_class = table + out_class_first[class_n] * n_stride;
+                for (k = 0; k < 256 && v[k * k_stride] == v_class[k * k_stride]; k++) {}
+                if (k == 256)
+                    break;
+            }
+        if (class_n == classes_count)
+            out_class_first[classes_count++] = n;
+        out_classes[n] = (ImU8)class_n;
+    }
+    return classes_count;
+}
+
+// Kerning pairs between code points 0..255 are also stored as a matrix of classes, so GetKerningAdvance() can avoid a hash lookup for them.
+// Fonts typically define kerning for groups of similar glyphs (e.g. 'T', 'Y' and 'V' against lowercase vowels), so this matrix is small.
+void ImFont::BuildKerningClasses()
+{
+    KerningClasses.clear();
+    KerningClassAdvanceX.clear();
+    KerningClassesRightCount = 0;
+
+    ImVector<float> table;
+    for (int n = 0; n < KerningPairs.Size; n++)
+    {
+        const ImFontKerningPair& pair = KerningPairs[n];
+        if (pair.Left == 0 || pair.Left >= 256 || pair.Right >= 256)
+            continue;
+        if (table.empty())
+            table.resize(256 * 256, 0.0f);
+        table[pair.Left * 256 + pair.Right] = pair.AdvanceX;
+    }
+    if (table.empty())
+        return;
+
+    int left_first[256], right_first[256];
+    KerningClasses.resize(512);
+    const int left_count = ImFontKerningCalcClasses(table.Data, 256, 1, &KerningClasses[0], left_first);
+    const int right_count = ImFontKerningCalcClasses(table.Data, 1, 256, &KerningClasses[256], right_first);
+    KerningClassesRightCount = right_count;
+    KerningClassAdvanceX.resize(left_count * right_count);
+    for (int left_class = 0; left_class < left_count; left_class++)
+        for (int right_class = 0; right_class < right_count; right_class++)
+            KerningClassAdvanceX[left_class * right_count + right_class] = table[left_first[left_class] * 256 + right_first[right_class]];
+}
+
 void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
 {
     IM_ASSERT(IndexLookup.Size > 0);    // Currently this can only be called AFTER the font has been built, aka after calling ImFontAtlas::GetTexDataAs*() function.
-    int index_size = IndexLookup.Size;
+    const int src_slot = GetIndexSlot(src);
+    const int dst_slot = GetIndexSlot(dst);
 
-    if (dst < index_size && IndexLookup.Data[dst] == (ImWchar)-1 && !overwrite_dst) // 'dst' already exists
+    if (dst_slot >= 0 && IndexLookup.Data[dst_slot] == (ImU16)-1 && !overwrite_dst) // 'dst' already exists
         return;
-    if (src >= index_size && dst >= index_size) // both 'dst' and 'src' don't exist -> no-op
+    if (src_slot < 0 && dst_slot < 0) // both 'dst' and 'src' don't exist -> no-op
         return;
 
-    GrowIndex(dst + 1);
-    IndexLookup[dst] = (src < index_size) ? IndexLookup.Data[src] : (ImWchar)-1;
-    IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
+    const ImU16 glyph_index = (src_slot >= 0) ? IndexLookup.Data[src_slot] : (ImU16)-1;
+    const float advance_x = (src_slot >= 0) ? IndexAdvanceX.Data[src_slot] : 1.0f;
+    const int slot = AllocIndexSlot(dst);
+    IndexLookup[slot] = glyph_index;
+    IndexAdvanceX[slot] = advance_x;
+}
+
+bool ImFont::IsGlyphRangeUnused(unsigned int c_begin, unsigned int c_last) const
+{
+    for (unsigned int page_n = c_begin >> 8; page_n <= (c_last >> 8) && page_n < (unsigned int)IndexPages.Size; page_n++)
+        if (IndexPages.Data[page_n] != 0)
+            return false;
+    return true;
 }
 
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
 {
-    if (c >= IndexLookup.Size)
+    const int slot = GetIndexSlot(c);
+    if (slot < 0)
         return FallbackGlyph;
-    const ImWchar i = IndexLookup.Data[c];
-    if (i == (ImWchar)-1)
+    const ImU16 i = IndexLookup.Data[slot];
+    if (i == (ImU16)-1)
         return FallbackGlyph;
-    return &Glyphs.Data[i];
+    const ImFontGlyph* glyph = &Glyphs.Data[i];
+    if (glyph->Dynamic)
+        ImFontAtlasDynamicUseGlyph(ContainerAtlas, (ImFont*)this, (int)i);
+    return glyph;
 }
 
 const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
 {
-    if (c >= IndexLookup.Size)
+    const int slot = GetIndexSlot(c);
+    if (slot < 0)
         return NULL;
-    const ImWchar i = IndexLookup.Data[c];
-    if (i == (ImWchar)-1)
+    const ImU16 i = IndexLookup.Data[slot];
+    if (i == (ImU16)-1)
         return NULL;
     return &Glyphs.Data[i];
 }
@@ -2659,6 +3846,9 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
     const char* prev_word_end = NULL;
     bool inside_word = true;
 
+    const bool kerning_enabled = (KerningPairsCount > 0);
+    ImWchar prev_c = 0;
+
     const char* s = text;
     while (s < text_end)
     {
@@ -2677,6 +3867,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
             {
                 line_width = word_width = blank_width = 0.0f;
                 inside_word = true;
+                prev_c = 0;
                 s = next_s;
                 continue;
             }
@@ -2687,7 +3878,13 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
             }
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX);
+        const int slot = GetIndexSlot(c);
+        float char_width = (slot >= 0) ? IndexAdvanceX.Data[slot] : FallbackAdvanceX;
+        if (kerning_enabled)
+        {
+            char_width += GetKerningAdvance(prev_c, (ImWchar)c);
+            prev_c = (ImWchar)c;
+        }
         if (ImCharIsBlankW(c))
         {
             if (inside_word)
@@ -2746,6 +3943,13 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
 
+    // Kerning of a character applies when it follows another character of the same line (see ImFontConfig::Kerning)
+    const bool kerning_enabled = (KerningPairsCount > 0);
+    ImWchar prev_c = 0;
+
+    // Advances of code points 0..255 are stored contiguously, so runs of printable ASCII characters can be measured without decoding nor paging.
+    const float* ascii_advance_x = (IndexPages.Size > 0) ? &IndexAdvanceX.Data[(int)IndexPages.Data[0] << 8] : NULL;
+
     const char* s = text_begin;
     while (s < text_end)
     {
@@ -2766,6 +3970,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 text_size.y += line_height;
                 line_width = 0.0f;
                 word_wrap_eol = NULL;
+                prev_c = 0;
 
                 // Wrapping skips upcoming blanks
                 while (s < text_end)
@@ -2777,6 +3982,50 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Fast path for runs of printable ASCII characters
+        if (ascii_advance_x != NULL && (unsigned char)*s >= 0x20 && (unsigned char)*s < 0x80)
+        {
+            const char* run_end = ImTextFindNonAscii(s, word_wrap_enabled ? word_wrap_eol : text_end, 0x20);
+            if (kerning_enabled && prev_c < 256 && KerningClassAdvanceX.Size > 0)
+            {
+                // Kerning between code points 0..255 is a lookup in the small matrix of kerning classes
+                const ImU8* kerning_classes = KerningClasses.Data;
+                const float* kerning_advance_x = KerningClassAdvanceX.Data;
+                const int kerning_stride = KerningClassesRightCount;
+                int kerning_row = kerning_classes[prev_c] * kerning_stride;
+                while (s < run_end)
+                {
+                    const unsigned int c = (unsigned char)*s;
+                    const float char_width = (ascii_advance_x[c] + kerning_advance_x[kerning_row + kerning_classes[256 + c]]) * scale;
+                    if (line_width + char_width >= max_width)
+                        break;
+                    line_width += char_width;
+                    kerning_row = kerning_classes[c] * kerning_stride;
+                    prev_c = (ImWchar)c;
+                    s++;
+                }
+            }
+            else
+            {
+                while (s < run_end)
+                {
+                    const ImWchar c = (ImWchar)(unsigned char)*s;
+                    float char_width = ascii_advance_x[c];
+                    if (kerning_enabled)
+                        char_width += GetKerningAdvance(prev_c, c);
+                    char_width *= scale;
+                    if (line_width + char_width >= max_width)
+                        break;
+                    line_width += char_width;
+                    prev_c = c;
+                    s++;
+                }
+            }
+            if (s < run_end)
+                break;
+            continue;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -2798,13 +4047,18 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 text_size.x = ImMax(text_size.x, line_width);
                 text_size.y += line_height;
                 line_width = 0.0f;
+                prev_c = 0;
                 continue;
             }
             if (c == '\r')
                 continue;
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX) * scale;
+        const int slot = GetIndexSlot(c);
+        float char_width = (slot >= 0) ? IndexAdvanceX.Data[slot] : FallbackAdvanceX;
+        if (kerning_enabled)
+            char_width += GetKerningAdvance(prev_c, (ImWchar)c);
+        char_width *= scale;
         if (line_width + char_width >= max_width)
         {
             s = prev_s;
@@ -2812,6 +4066,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
         }
 
         line_width += char_width;
+        prev_c = (ImWchar)c;
     }
 
     if (text_size.x < line_width)
@@ -2857,6 +4112,11 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     const float line_height = FontSize * scale;
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    const bool kerning_enabled = (KerningPairsCount > 0);
+    const ImU8* kerning_classes = KerningClasses.Data; // Our writes to the vertex buffer would otherwise force reloading those
+    const float* kerning_advance_x = KerningClassAdvanceX.Data;
+    const int kerning_stride = KerningClassesRightCount;
+    ImWchar prev_c = 0;
 
     // Fast-forward to first visible line
     const char* s = text_begin;
@@ -2912,6 +4172,7 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
                 x = pos.x;
                 y += line_height;
                 word_wrap_eol = NULL;
+                prev_c = 0;
 
                 // Wrapping skips upcoming blanks
                 while (s < text_end)
@@ -2942,6 +4203,7 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
             {
                 x = pos.x;
                 y += line_height;
+                prev_c = 0;
                 if (y > clip_rect.w)
                     break; // break out of main loop
                 continue;
@@ -2950,6 +4212,15 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
                 continue;
         }
 
+        if (kerning_enabled)
+        {
+            if ((prev_c | c) < 256)
+                x += (kerning_advance_x ? kerning_advance_x[kerning_classes[prev_c] * kerning_stride + kerning_classes[256 + c]] : 0.0f) * scale;
+            else
+                x += FindKerningPairAdvance(prev_c, (ImWchar)c) * scale;
+            prev_c = (ImWchar)c;
+        }
+
         float char_width = 0.0f;
         if (const ImFontGlyph* glyph = FindGlyph((ImWchar)c))
         {
@@ -36,6 +36,15 @@ Index of this file:
 #include <math.h>       // sqrtf, fabsf, fmodf, powf, floorf, ceilf, cosf, sinf
 #include <limits.h>     // INT_MIN, INT_MAX
 
+// Enable SSE2/NEON intrinsics if available (used to skip over runs of ASCII characters in the text functions)
+#if (defined __SSE2__ || defined __x86_64__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)) && !defined(IMGUI_DISABLE_SSE)
+#define IMGUI_ENABLE_SSE
+#include <emmintrin.h>
+#elif (defined __ARM_NEON || defined __ARM_NEON__) && !defined(IMGUI_DISABLE_NEON)
+#define IMGUI_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+
 // Visual Studio warnings
 #ifdef _MSC_VER
 #pragma warning (push)
@@ -72,11 +81,15 @@ struct ImGuiColumnData;             // Storage data for a single column
 struct ImGuiColumns;                // Storage data for a columns set
 struct ImGuiContext;                // Main Dear ImGui context
 struct ImGuiDataTypeInfo;           // Type information associated to a ImGuiDataType enum
+struct ImGuiDataTypeFormatCacheEntry; // Cached result of DataTypeFormatString()
 struct ImGuiGroupData;              // Stacked storage data for BeginGroup()/EndGroup()
 struct ImGuiInputTextState;         // Internal state of the currently focused/edited text input box
+struct ImGuiInputTextUndoState;     // Undo/redo history of the currently focused/edited text input box
 struct ImGuiItemHoveredDataBackup;  // Backup and restore IsItemHovered() internal data
 struct ImGuiMenuColumns;            // Simple column measurement, currently used for MenuItem() only
 struct ImGuiNavMoveResult;          // Result of a directional navigation move query result
+struct ImGuiMemoryStats;             // Memory owned by a context, per category
+struct ImGuiMetricsConfig;          // Storage for ShowMetricsWindow() options
 struct ImGuiNextWindowData;         // Storage for SetNextWindow** functions
 struct ImGuiNextItemData;           // Storage for SetNextItem** functions
 struct ImGuiPopupData;              // Storage for current popup stack
@@ -90,6 +103,7 @@ struct ImGuiWindowSettings;         // Storage for window settings stored in .in
 
 // Use your programming IDE "Go to definition" facility on the names of the center columns to find the actual flags/enum lists.
 typedef int ImGuiLayoutType;            // -> enum ImGuiLayoutType_         // Enum: Horizontal or vertical
+typedef int ImGuiMemoryCategory;        // -> enum ImGuiMemoryCategory_     // Enum: Category of memory owned by a context, for ImGuiMemoryStats
 typedef int ImGuiButtonFlags;           // -> enum ImGuiButtonFlags_        // Flags: for ButtonEx(), ButtonBehavior()
 typedef int ImGuiColumnsFlags;          // -> enum ImGuiColumnsFlags_       // Flags: BeginColumns()
 typedef int ImGuiDragFlags;             // -> enum ImGuiDragFlags_          // Flags: for DragBehavior()
@@ -108,16 +122,61 @@ typedef int ImGuiTextFlags;             // -> enum ImGuiTextFlags_          // F
 // STB libraries includes
 //-------------------------------------------------------------------------
 
+// Undo/redo history of InputText(), replacing the fixed-size undo buffers of imstb_textedit.h (see STB_TEXTEDIT_UNDOSTATE)
+// Storage is only allocated once the text is edited. Runs of typed or deleted characters are merged into a single record.
+// The oldest records are discarded when io.ConfigInputTextUndoBudget is exceeded.
+enum ImGuiInputTextUndoMerge_
+{
+    ImGuiInputTextUndoMerge_None,
+    ImGuiInputTextUndoMerge_Typing,         // Insertion of typed characters, may be extended by the next typed character
+    ImGuiInputTextUndoMerge_Deleting        // Deletion of characters with Backspace/Delete, may be extended by the next deletion
+};
+
+struct ImGuiInputTextUndoRecord
+{
+    int         Where;                      // Position of the change (in bytes)
+    int         InsertLen;                  // Number of bytes to insert back when applying the record, stored in Chars[] of the owning stack
+    int         DeleteLen;                  // Number of bytes to delete when applying the record
+    int         CharStorage;                // Offset of the bytes to insert in Chars[] of the owning stack
+    int         MergeKind;                  // ImGuiInputTextUndoMerge_
+};
+
+struct ImGuiInputTextUndoStack
+{
+    ImVector<ImGuiInputTextUndoRecord> Records;
+    ImVector<char>  Chars;
+    int             RecordsFirst;           // Number of records discarded at the front of Records[], compacted lazily
+    int             CharsFirst;             // Number of bytes discarded at the front of Chars[], compacted lazily
+
+    int         GetCount() const            { return Records.Size - RecordsFirst; }
+    size_t      GetBytes() const            { return (size_t)GetCount() * sizeof(ImGuiInputTextUndoRecord) + (size_t)(Chars.Size - CharsFirst); }
+    void        Clear()                     { Records.resize(0); Chars.resize(0); RecordsFirst = CharsFirst = 0; }
+    void        ClearFreeMemory()           { Records.clear(); Chars.clear(); RecordsFirst = CharsFirst = 0; }
+    char*       Push(int where, int insert_len, int delete_len, int merge_kind);   // Return storage for the insert_len bytes
+    void        DiscardFirst();
+};
+
+struct ImGuiInputTextUndoState
+{
+    ImGuiInputTextUndoStack UndoStack;
+    ImGuiInputTextUndoStack RedoStack;
+    int         NextMergeKind;              // Set while handling a key, to allow extending the last undo record
+
+    void        Clear()                     { UndoStack.Clear(); RedoStack.Clear(); }
+    void        ClearFreeMemory()           { UndoStack.ClearFreeMemory(); RedoStack.ClearFreeMemory(); }
+    void        DisableMerge()              { if (UndoStack.GetCount() > 0) UndoStack.Records.back().MergeKind = ImGuiInputTextUndoMerge_None; }
+    bool        TrimToBudget(size_t budget);   // Discard oldest undo records until under budget, return false if still over
+};
+
 namespace ImStb
 {
 
 #undef STB_TEXTEDIT_STRING
 #undef STB_TEXTEDIT_CHARTYPE
 #define STB_TEXTEDIT_STRING             ImGuiInputTextState
-#define STB_TEXTEDIT_CHARTYPE           ImWchar
+#define STB_TEXTEDIT_CHARTYPE           char
 #define STB_TEXTEDIT_GETWIDTH_NEWLINE   -1.0f
-#define STB_TEXTEDIT_UNDOSTATECOUNT     99
-#define STB_TEXTEDIT_UNDOCHARCOUNT      999
+#define STB_TEXTEDIT_UNDOSTATE          ImGuiInputTextUndoState
 #include "imstb_textedit.h"
 
 } // namespace ImStb
@@ -127,8 +186,12 @@ namespace ImStb
 //-----------------------------------------------------------------------------
 
 #ifndef GImGui
+#ifdef IMGUI_ENABLE_THREAD_LOCAL_CONTEXT
+extern thread_local ImGuiContext* GImGui;   // Current implicit context pointer, one per thread (not exported with IMGUI_API: thread_local variables can't be imported from a DLL)
+#else
 extern IMGUI_API ImGuiContext* GImGui;  // Current implicit context pointer
 #endif
+#endif
 
 //-----------------------------------------------------------------------------
 // Generic helpers
@@ -164,14 +227,18 @@ IMGUI_API int           ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char
 IMGUI_API int           ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end);                            // return number of UTF-8 code-points (NOT bytes count)
 IMGUI_API int           ImTextCountUtf8BytesFromChar(const char* in_text, const char* in_text_end);                        // return number of bytes to express one char in UTF-8
 IMGUI_API int           ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_end);                   // return number of bytes to express string in UTF-8
+IMGUI_API const char*   ImTextFindNonAscii(const char* in_text, const char* in_text_end, char min_char = 1);                // return first byte outside of the [min_char..0x7F] range, or in_text_end
 
 // Helpers: Misc
 IMGUI_API ImU32         ImHashData(const void* data, size_t data_size, ImU32 seed = 0);
 IMGUI_API ImU32         ImHashStr(const char* data, size_t data_size = 0, ImU32 seed = 0);
 IMGUI_API void*         ImFileLoadToMemory(const char* filename, const char* file_open_mode, size_t* out_file_size = NULL, int padding_bytes = 0);
 IMGUI_API FILE*         ImFileOpen(const char* filename, const char* file_open_mode);
+IMGUI_API bool          ImFileRename(const char* src_filename, const char* dst_filename);         // Replace 'dst_filename' if it exists (atomically on Windows and POSIX)
+IMGUI_API bool          ImFileRemove(const char* filename);
 static inline bool      ImCharIsBlankA(char c)          { return c == ' ' || c == '\t'; }
 static inline bool      ImCharIsBlankW(unsigned int c)  { return c == ' ' || c == '\t' || c == 0x3000; }
+static inline char      ImCharToLowerA(char c)          { return (c >= 'A' && c <= 'Z') ? (char)(c + 'a' - 'A') : c; }
 static inline bool      ImIsPowerOfTwo(int v)           { return v != 0 && (v & (v - 1)) == 0; }
 static inline int       ImUpperPowerOfTwo(int v)        { v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16; v++; return v; }
 #define ImQsort         qsort
@@ -197,6 +264,7 @@ IMGUI_API int           ImStrlenW(const ImWchar* str);
 IMGUI_API const char*   ImStreolRange(const char* str, const char* str_end);                // End end-of-line
 IMGUI_API const ImWchar*ImStrbolW(const ImWchar* buf_mid_line, const ImWchar* buf_begin);   // Find beginning-of-line
 IMGUI_API const char*   ImStristr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end);
+IMGUI_API const char*   ImStristrLower(const char* haystack, const char* haystack_end, const char* needle_lower, const char* needle_lower_end); // Faster ImStristr() for a needle already in lowercase, haystack_end required
 IMGUI_API void          ImStrTrimBlanks(char* str);
 IMGUI_API int           ImFormatString(char* buf, size_t buf_size, const char* fmt, ...) IM_FMTARGS(3);
 IMGUI_API int           ImFormatStringV(char* buf, size_t buf_size, const char* fmt, va_list args) IM_FMTLIST(3);
@@ -580,6 +648,16 @@ struct ImGuiDataTypeInfo
     const char* ScanFmt;        // Default scanf format for the type
 };
 
+// Cached result of DataTypeFormatString(), see ImGuiContext::DataTypeFormatCache (64 bytes)
+struct ImGuiDataTypeFormatCacheEntry
+{
+    ImU64       Value;          // Value, zero-extended to 64-bit
+    ImU8        DataType;       // ImGuiDataType_COUNT when unused
+    ImU8        TextLen;
+    char        Format[22];     // Zero-terminated
+    char        Text[32];       // Zero-terminated
+};
+
 // Stacked color modifier, backup of modified data so we can restore it
 struct ImGuiColorMod
 {
@@ -625,14 +703,14 @@ struct IMGUI_API ImGuiMenuColumns
 };
 
 // Internal state of the currently focused/edited text input box
+// The text is edited in UTF-8: all positions (stb_textedit cursor and selection, line starts) are byte offsets in TextA.
 struct IMGUI_API ImGuiInputTextState
 {
     ImGuiID                 ID;                     // widget id owning the text state
-    int                     CurLenW, CurLenA;       // we need to maintain our buffer length in both UTF-8 and wchar format. UTF-8 len is valid even if TextA is not.
-    ImVector<ImWchar>       TextW;                  // edit buffer, we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer.
-    ImVector<char>          TextA;                  // temporary UTF8 buffer for callbacks and other operations. this is not updated in every code-path! size=capacity.
+    int                     CurLenA;                // length of TextA in bytes
+    ImVector<char>          TextA;                  // edit buffer (UTF-8), we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer. size=capacity.
     ImVector<char>          InitialTextA;           // backup of end-user buffer at the time of focus (in UTF-8, unaltered)
-    bool                    TextAIsValid;           // temporary UTF8 buffer is not initially valid before we make the widget active (until then we pull the data from user argument)
+    ImVector<int>           LineStarts;             // offset of every line in TextA, maintained by edits so we only need to measure and render visible lines. empty when it needs to be rebuilt.
     int                     BufCapacityA;           // end-user buffer capacity
     float                   ScrollX;                // horizontal scrolling/offset
     ImStb::STB_TexteditState Stb;                   // state for stb_textedit.h
@@ -644,18 +722,60 @@ struct IMGUI_API ImGuiInputTextState
     void*                   UserCallbackData;       // "
 
     ImGuiInputTextState()                   { memset(this, 0, sizeof(*this)); }
-    void        ClearText()                 { CurLenW = CurLenA = 0; TextW[0] = 0; TextA[0] = 0; CursorClamp(); }
-    void        ClearFreeMemory()           { TextW.clear(); TextA.clear(); InitialTextA.clear(); }
-    int         GetUndoAvailCount() const   { return Stb.undostate.undo_point; }
-    int         GetRedoAvailCount() const   { return STB_TEXTEDIT_UNDOSTATECOUNT - Stb.undostate.redo_point; }
+    void        ClearText()                 { CurLenA = 0; TextA[0] = 0; OnTextReplaced(); CursorClamp(); }
+    void        ClearFreeMemory()           { TextA.clear(); InitialTextA.clear(); LineStarts.clear(); Stb.undostate.ClearFreeMemory(); }
+    int         GetUndoAvailCount() const   { return Stb.undostate.UndoStack.GetCount(); }
+    int         GetRedoAvailCount() const   { return Stb.undostate.RedoStack.GetCount(); }
     void        OnKeyPressed(int key);      // Cannot be inline because we call in code in stb_textedit.h implementation
+    void        OnCharPressed(unsigned int c);                                                          // Insert a character, encoded as UTF-8
+    void        OnTextReplaced()            { LineStarts.resize(0); }                                  // Call when TextA has been rewritten other than through STB_TEXTEDIT_DELETECHARS()/STB_TEXTEDIT_INSERTCHARS()
+
+    // Line index
+    void        UpdateLineIndex();                                                                      // Rebuild LineStarts[] if it was invalidated by OnTextReplaced()
+    int         FindLineNo(int pos) const;                                                              // Binary search the line containing a position in TextA
+    void        LineIndexInsert(int pos, const char* text, int text_len);
+    void        LineIndexDelete(int pos, int len);
 
     // Cursor & Selection
     void        CursorAnimReset()           { CursorAnim = -0.30f; }                                   // After a user-input the cursor stays on for a while without blinking
-    void        CursorClamp()               { Stb.cursor = ImMin(Stb.cursor, CurLenW); Stb.select_start = ImMin(Stb.select_start, CurLenW); Stb.select_end = ImMin(Stb.select_end, CurLenW); }
+    void        CursorClamp()               { Stb.cursor = ClampPosToChar(Stb.cursor); Stb.select_start = ClampPosToChar(Stb.select_start); Stb.select_end = ClampPosToChar(Stb.select_end); }
+    int         ClampPosToChar(int pos) const { pos = ImClamp(pos, 0, CurLenA); while (pos > 0 && (TextA.Data[pos] & 0xC0) == 0x80) pos--; return pos; } // Clamp a byte offset into TextA and move it back to the start of its UTF-8 sequence
     bool        HasSelection() const        { return Stb.select_start != Stb.select_end; }
     void        ClearSelection()            { Stb.select_start = Stb.select_end = Stb.cursor; }
-    void        SelectAll()                 { Stb.select_start = 0; Stb.cursor = Stb.select_end = CurLenW; Stb.has_preferred_x = 0; }
+    void        SelectAll()                 { Stb.select_start = 0; Stb.cursor = Stb.select_end = CurLenA; Stb.has_preferred_x = 0; }
+};
+
+enum ImGuiMemoryCategory_
+{
+    ImGuiMemoryCategory_Windows,            // ImGuiWindow structures and names
+    ImGuiMemoryCategory_DrawLists,          // ImDrawList buffers
+    ImGuiMemoryCategory_WindowBuffers,      // Transient per-window buffers (IDStack, DC stacks), freed by GcCompactTransientWindowBuffers()
+    ImGuiMemoryCategory_WindowStorage,      // Persistent per-window storage (StateStorage, ColumnsStorage)
+    ImGuiMemoryCategory_TabBars,
+    ImGuiMemoryCategory_InputText,
+    ImGuiMemoryCategory_Settings,
+    ImGuiMemoryCategory_Misc,               // Context-wide stacks and lookup tables
+    ImGuiMemoryCategory_COUNT
+};
+
+// Heap memory owned by a context, as returned by GcCalcMemoryStats(). Sizes are in bytes and based on buffers capacity.
+struct ImGuiMemoryStats
+{
+    size_t      Bytes[ImGuiMemoryCategory_COUNT];
+
+    ImGuiMemoryStats()          { memset(this, 0, sizeof(*this)); }
+    size_t      GetTotal() const{ size_t total = 0; for (int n = 0; n < ImGuiMemoryCategory_COUNT; n++) total += Bytes[n]; return total; }
+};
+
+// Options of the Metrics window, stored in the context rather than in static variables so contexts may run on different threads
+struct ImGuiMetricsConfig
+{
+    bool        ShowWindowsRects;
+    bool        ShowWindowsBeginOrder;
+    bool        ShowDrawCmdClipRects;
+    int         ShowWindowsRectsType;
+
+    ImGuiMetricsConfig() { ShowWindowsRects = ShowWindowsBeginOrder = false; ShowDrawCmdClipRects = true; ShowWindowsRectsType = -1; }
 };
 
 // Windows data saved in imgui.ini file
@@ -666,8 +786,11 @@ struct ImGuiWindowSettings
     ImVec2ih    Pos;
     ImVec2ih    Size;
     bool        Collapsed;
+    bool        WantParse;      // Entry was loaded from .ini data but its lines haven't been parsed yet. They are parsed on the first FindWindowSettings() call.
+    int         IniBodyOffset;  // Offset of the entry lines in g.SettingsIniData, or -1 if the entry changed since it was last saved/loaded.
+    int         IniBodyLen;
 
-    ImGuiWindowSettings() { Name = NULL; ID = 0; Pos = Size = ImVec2ih(0, 0); Collapsed = false; }
+    ImGuiWindowSettings() { Name = NULL; ID = 0; Pos = Size = ImVec2ih(0, 0); Collapsed = WantParse = false; IniBodyOffset = -1; IniBodyLen = 0; }
 };
 
 struct ImGuiSettingsHandler
@@ -860,6 +983,7 @@ struct ImGuiContext
     bool                    FrameScopeActive;                   // Set by NewFrame(), cleared by EndFrame()
     bool                    FrameScopePushedImplicitWindow;     // Set by NewFrame(), cleared by EndFrame()
     bool                    FontAtlasOwnedByContext;            // Io.Fonts-> is owned by the ImGuiContext and will be destructed along with it.
+    bool                    FontAtlasLockedByContext;           // Io.Fonts->Locked was set by our NewFrame() and will be cleared by our EndFrame(). False if the atlas was already locked (e.g. shared between threads).
     ImGuiIO                 IO;
     ImGuiStyle              Style;
     ImFont*                 Font;                               // (Shortcut) == FontStack.empty() ? IO.Font : FontStack.back()
@@ -875,9 +999,13 @@ struct ImGuiContext
     ImVector<ImGuiWindow*>  Windows;                            // Windows, sorted in display order, back to front
     ImVector<ImGuiWindow*>  WindowsFocusOrder;                  // Windows, sorted in focus order, back to front
     ImVector<ImGuiWindow*>  WindowsSortBuffer;
+    ImVector<ImGuiWindow*>  WindowsActiveRoots;                 // Active root windows, sorted in display order, back to front. Rebuilt along with Windows[] by EndFrame().
     ImVector<ImGuiWindow*>  CurrentWindowStack;
     ImGuiStorage            WindowsById;
     int                     WindowsActiveCount;
+    int                     WindowsActiveCountPrev;             // WindowsActiveCount of the last EndFrame(), to detect windows getting deactivated.
+    int                     WindowsNewlyActiveCount;            // Number of windows active this frame which weren't active on the previous frame.
+    bool                    WindowsSortDirty;                   // Set when Windows[] order or a parent-child link changed: EndFrame() needs to sort Windows[] again.
     ImGuiWindow*            CurrentWindow;                      // Being drawn into
     ImGuiWindow*            HoveredWindow;                      // Will catch mouse inputs
     ImGuiWindow*            HoveredRootWindow;                  // Will catch mouse inputs (for focus/move only)
@@ -1010,6 +1138,8 @@ struct ImGuiContext
     ImGuiInputTextState     InputTextState;
     ImFont                  InputTextPasswordFont;
     ImGuiID                 TempInputTextId;                    // Temporary text input when CTRL+clicking on a slider, etc.
+    ImVector<ImGuiDataTypeFormatCacheEntry> DataTypeFormatCache;// Results of DataTypeFormatString(), 2-way set associative on a hash of value and format, as most values displayed by widgets don't change every frame
+    int                     DataTypeFormatCacheMisses;          // Misses this frame, the cache grows when they exceed half of its size
     ImGuiColorEditFlags     ColorEditOptions;                   // Store user options for color edit widgets
     float                   ColorEditLastHue;
     float                   ColorEditLastColor[3];
@@ -1033,8 +1163,10 @@ struct ImGuiContext
     bool                           SettingsLoaded;
     float                          SettingsDirtyTimer;          // Save .ini Settings to memory when time reaches zero
     ImGuiTextBuffer                SettingsIniData;             // In memory .ini settings
+    ImGuiTextBuffer                SettingsIniDataNext;         // Output buffer for SaveIniSettingsToMemory(), swapped with SettingsIniData when done, so handlers may copy unchanged entries from the previous data
     ImVector<ImGuiSettingsHandler> SettingsHandlers;            // List of .ini settings handlers
     ImVector<ImGuiWindowSettings>  SettingsWindows;             // ImGuiWindow .ini settings entries (parsed from the last loaded .ini file and maintained on saving)
+    ImGuiStorage                   SettingsWindowsMap;          // ID -> index into SettingsWindows[]
 
     // Logging
     bool                    LogEnabled;
@@ -1050,6 +1182,10 @@ struct ImGuiContext
     // Debug Tools
     bool                    DebugItemPickerActive;
     ImGuiID                 DebugItemPickerBreakID;             // Will call IM_DEBUG_BREAK() when encountering this id
+    ImGuiMetricsConfig      DebugMetricsConfig;
+
+    // Garbage collection
+    float                   GcMemoryBudgetTimer;                // Check io.ConfigMemoryCompactBudget when time reaches zero
 
     // Misc
     float                   FramerateSecPerFrame[120];          // Calculate estimate of framerate for user over the last 2 seconds.
@@ -1067,12 +1203,14 @@ struct ImGuiContext
         Font = NULL;
         FontSize = FontBaseSize = 0.0f;
         FontAtlasOwnedByContext = shared_font_atlas ? false : true;
+        FontAtlasLockedByContext = false;
         IO.Fonts = shared_font_atlas ? shared_font_atlas : IM_NEW(ImFontAtlas)();
         Time = 0.0f;
         FrameCount = 0;
         FrameCountEnded = FrameCountRendered = -1;
 
-        WindowsActiveCount = 0;
+        WindowsActiveCount = WindowsActiveCountPrev = WindowsNewlyActiveCount = 0;
+        WindowsSortDirty = false;
         CurrentWindow = NULL;
         HoveredWindow = NULL;
         HoveredRootWindow = NULL;
@@ -1156,6 +1294,7 @@ struct ImGuiContext
 
         LastValidMousePos = ImVec2(0.0f, 0.0f);
         TempInputTextId = 0;
+        DataTypeFormatCacheMisses = 0;
         ColorEditOptions = ImGuiColorEditFlags__OptionsDefault;
         ColorEditLastHue = 0.0f;
         ColorEditLastColor[0] = ColorEditLastColor[1] = ColorEditLastColor[2] = FLT_MAX;
@@ -1183,6 +1322,8 @@ struct ImGuiContext
         DebugItemPickerActive = false;
         DebugItemPickerBreakID = 0;
 
+        GcMemoryBudgetTimer = 0.0f;
+
         memset(FramerateSecPerFrame, 0, sizeof(FramerateSecPerFrame));
         FramerateSecPerFrameIdx = 0;
         FramerateSecPerFrameAccum = 0.0f;
@@ -1438,6 +1579,7 @@ struct ImGuiTabBar
     ImGuiID             VisibleTabId;           // Can occasionally be != SelectedTabId (e.g. when previewing contents for CTRL+TAB preview)
     int                 CurrFrameVisible;
     int                 PrevFrameVisible;
+    ImGuiWindow*        Window;                 // Window which submitted the tab bar last (GcCompactToMemoryBudget() only discards tab bars of inactive windows)
     ImRect              BarRect;
     float               LastTabContentHeight;   // Record the height of contents submitted below the tab bar
     float               OffsetMax;              // Distance from BarRect.Min.x, locked during layout
@@ -1495,11 +1637,17 @@ namespace ImGui
     IMGUI_API void          SetWindowCollapsed(ImGuiWindow* window, bool collapsed, ImGuiCond cond = 0);
     IMGUI_API void          GcCompactTransientWindowBuffers(ImGuiWindow* window);
     IMGUI_API void          GcAwakeTransientWindowBuffers(ImGuiWindow* window);
+    IMGUI_API void          GcDiscardWindowStorage(ImGuiWindow* window);
+    IMGUI_API void          GcCalcMemoryStats(ImGuiMemoryStats* out_stats);
+    IMGUI_API void          GcCompactToMemoryBudget(size_t budget);
 
     IMGUI_API void          SetCurrentFont(ImFont* font);
     inline ImFont*          GetDefaultFont() { ImGuiContext& g = *GImGui; return g.IO.FontDefault ? g.IO.FontDefault : g.IO.Fonts->Fonts[0]; }
     inline ImDrawList*      GetForegroundDrawList(ImGuiWindow*) { ImGuiContext& g = *GImGui; return &g.ForegroundDrawList; } // This seemingly unnecessary wrapper simplifies compatibility between the 'master' and 'docking' branches.
 
+    // Memory allocators (same as MemAlloc()/MemFree() without touching the current context, e.g. to allocate from other threads)
+    IMGUI_API void          GetAllocatorFunctions(void* (**p_alloc_func)(size_t sz, void* user_data), void (**p_free_func)(void* ptr, void* user_data), void** p_user_data);
+
     // Init
     IMGUI_API void          Initialize(ImGuiContext* context);
     IMGUI_API void          Shutdown(ImGuiContext* context);    // Since 1.60 this is a _private_ function. You can call DestroyContext() to destroy the context created by CreateContext().
@@ -1703,11 +1851,15 @@ namespace ImGui
 } // namespace ImGui
 
 // ImFontAtlas internals
+#define IM_FONTATLAS_KERNING_GLYPHS_MAX     256     // ImFontConfig::Kerning: pairs are looked up between the first N glyphs of each font input, which is O(N^2) at build time
 IMGUI_API bool              ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas);
 IMGUI_API void              ImFontAtlasBuildRegisterDefaultCustomRects(ImFontAtlas* atlas);
 IMGUI_API void              ImFontAtlasBuildSetupFont(ImFontAtlas* atlas, ImFont* font, ImFontConfig* font_config, float ascent, float descent);
 IMGUI_API void              ImFontAtlasBuildPackCustomRects(ImFontAtlas* atlas, void* stbrp_context_opaque);
+IMGUI_API void              ImFontAtlasBuildPackRects(ImFontAtlas* atlas, void* stbrp_rects_opaque, int rects_count); // Pack custom rects + 'rects' (stbrp_rect[]), choosing TexWidth for the smallest texture. Output TexWidth, TexHeight (before rounding), TexPackedSurface.
+IMGUI_API int               ImFontAtlasBuildCalcTexHeight(const ImFontAtlas* atlas, int tex_width, int packed_height); // Final texture height for a packed height (room for dynamic glyphs, power of two or multiple of 4 rounding)
 IMGUI_API void              ImFontAtlasBuildFinish(ImFontAtlas* atlas);
+IMGUI_API void              ImFontAtlasBuildUpdateDynamicGlyphs(ImFontAtlas* atlas);   // Called by NewFrame(): advance LRU frame counter, evict glyphs if the texture got full (ImFontAtlasFlags_DynamicGlyphs)
 IMGUI_API void              ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_multiply_factor);
 IMGUI_API void              ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsigned char* pixels, int x, int y, int w, int h, int stride);
 
@@ -15,6 +15,7 @@ Index of this file:
 // [SECTION] Widgets: SliderScalar, SliderFloat, SliderInt, etc.
 // [SECTION] Widgets: InputScalar, InputFloat, InputInt, etc.
 // [SECTION] Widgets: InputText, InputTextMultiline
+// [SECTION] Widgets: ImGuiTextView
 // [SECTION] Widgets: ColorEdit, ColorPicker, ColorButton, etc.
 // [SECTION] Widgets: TreeNode, CollapsingHeader, etc.
 // [SECTION] Widgets: Selectable
@@ -107,7 +108,7 @@ static const ImU64          IM_U64_MAX = (2ULL * 9223372036854775807LL + 1);
 // For InputTextEx()
 static bool             InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data);
 static int              InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end);
-static ImVec2           InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining = NULL, ImVec2* out_offset = NULL, bool stop_on_new_line = false);
+static ImVec2           InputTextCalcTextSize(const char* text_begin, const char* text_end, const char** remaining = NULL, ImVec2* out_offset = NULL, bool stop_on_new_line = false);
 
 //-------------------------------------------------------------------------
 // [SECTION] Widgets: Text, etc.
@@ -1678,7 +1679,7 @@ const ImGuiDataTypeInfo* ImGui::DataTypeGetInfo(ImGuiDataType data_type)
     return &GDataTypeInfo[data_type];
 }
 
-int ImGui::DataTypeFormatString(char* buf, int buf_size, ImGuiDataType data_type, const void* data_ptr, const char* format)
+static int DataTypeFormatStringNoCache(char* buf, int buf_size, ImGuiDataType data_type, const void* data_ptr, const char* format)
 {
     // Signedness doesn't matter when pushing integer arguments
     if (data_type == ImGuiDataType_S32 || data_type == ImGuiDataType_U32)
@@ -1701,6 +1702,59 @@ int ImGui::DataTypeFormatString(char* buf, int buf_size, ImGuiDataType data_type
     return 0;
 }
 
+// Widgets format their value every frame while it rarely changes, so we look for the same value and format in a cache first.
+// The cache starts small and doubles in size when more than half of it misses in a frame, e.g. for a property grid showing thousands of values.
+static const int DATATYPE_FORMAT_CACHE_SIZE_MIN = 256;     // Must be a power of two
+static const int DATATYPE_FORMAT_CACHE_SIZE_MAX = 4096;    // 256 KB
+
+int ImGui::DataTypeFormatString(char* buf, int buf_size, ImGuiDataType data_type, const void* data_ptr, const char* format)
+{
+    ImGuiContext& g = *GImGui;
+    IM_ASSERT(data_type >= 0 && data_type < ImGuiDataType_COUNT);
+    ImVector<ImGuiDataTypeFormatCacheEntry>& cache = g.DataTypeFormatCache;
+    if (cache.Size == 0 || (g.DataTypeFormatCacheMisses > cache.Size / 2 && cache.Size < DATATYPE_FORMAT_CACHE_SIZE_MAX))
+    {
+        cache.resize(cache.Size == 0 ? DATATYPE_FORMAT_CACHE_SIZE_MIN : cache.Size * 2);
+        for (int n = 0; n < cache.Size; n++)
+            cache[n].DataType = ImGuiDataType_COUNT;
+        g.DataTypeFormatCacheMisses = 0;
+    }
+
+    ImU64 value = 0;
+    memcpy(&value, data_ptr, GDataTypeInfo[data_type].Size);
+    // Hashing the format pointer rather than its contents is enough to spread entries (they are compared by contents)
+    const ImU64 hash = (value ^ ((ImU64)(intptr_t)format * 31 + (ImU64)data_type)) * 0x9E3779B97F4A7C15ULL;
+    ImGuiDataTypeFormatCacheEntry* set = &cache[(int)((ImU32)(hash >> 32) & (ImU32)(cache.Size / 2 - 1)) * 2];
+    for (int way = 0; way < 2; way++)
+    {
+        ImGuiDataTypeFormatCacheEntry* entry = &set[way];
+        if (entry->DataType == data_type && entry->Value == value && strcmp(entry->Format, format) == 0)
+        {
+            const int w = ImMin((int)entry->TextLen, buf_size - 1);
+            memcpy(buf, entry->Text, (size_t)w);
+            buf[w] = 0;
+            if (way == 1)
+                ImSwap(set[0], set[1]); // Most recently used first
+            return w;
+        }
+    }
+
+    g.DataTypeFormatCacheMisses++;
+    const int w = DataTypeFormatStringNoCache(buf, buf_size, data_type, data_ptr, format);
+    const size_t format_len = strlen(format);
+    ImGuiDataTypeFormatCacheEntry* entry = &set[0];
+    if (w >= 0 && w < buf_size - 1 && w < IM_ARRAYSIZE(entry->Text) && format_len < IM_ARRAYSIZE(entry->Format))
+    {
+        set[1] = set[0];
+        entry->Value = value;
+        entry->DataType = (ImU8)data_type;
+        entry->TextLen = (ImU8)w;
+        memcpy(entry->Format, format, format_len + 1);
+        memcpy(entry->Text, buf, (size_t)w + 1);
+    }
+    return w;
+}
+
 void ImGui::DataTypeApplyOp(ImGuiDataType data_type, int op, void* output, void* arg1, const void* arg2)
 {
     IM_ASSERT(op == '+' || op == '-');
@@ -1751,6 +1805,209 @@ void ImGui::DataTypeApplyOp(ImGuiDataType data_type, int op, void* output, void*
     IM_ASSERT(0);
 }
 
+// Parse a decimal integer as sscanf("%d") would (skipping leading blanks), saturating the magnitude on overflow.
+static const char* ImParseInteger(const char* src, bool* out_negative, ImU64* out_magnitude)
+{
+    while (ImCharIsBlankA(*src))
+        src++;
+    const bool negative = (*src == '-');
+    if (*src == '-' || *src == '+')
+        src++;
+    if (*src < '0' || *src > '9')
+        return NULL;
+    ImU64 magnitude = 0;
+    for (; *src >= '0' && *src <= '9'; src++)
+    {
+        const int digit = *src - '0';
+        magnitude = (magnitude > (IM_U64_MAX - digit) / 10) ? IM_U64_MAX : magnitude * 10 + digit;
+    }
+    *out_negative = negative;
+    *out_magnitude = magnitude;
+    return src;
+}
+
+// Decimal point of the C locale, as used by vsnprintf(), strtod() and sscanf(). We don't use localeconv() which isn't available everywhere (e.g. older Android NDK).
+// Multi-byte decimal points are ignored: we then only handle '.'.
+static char ImGetLocaleDecimalPoint()
+{
+    char buf[16];
+    sprintf(buf, "%.1f", 0.5);
+    return (buf[1] & 0x80) ? '.' : buf[1];
+}
+
+// Call strtod() (when 'out_double' is set) or sscanf("%f") on 'src', replacing any '.' with the decimal point of the C locale which they expect.
+// Return the end of the number in 'src' (for sscanf(), 'src' itself), or NULL on failure.
+static const char* ImParseFloatingWithLocale(const char* src, char locale_point, double* out_double, float* out_float)
+{
+    const char* s = src;
+    char local_buf[64];
+    char* buf = NULL;
+    if (locale_point != '.' && strchr(src, '.') != NULL)
+    {
+        const size_t len = strlen(src);
+        buf = (len < IM_ARRAYSIZE(local_buf)) ? local_buf : (char*)IM_ALLOC(len + 1);
+        memcpy(buf, src, len + 1);
+        for (char* c = buf; *c; c++)
+            if (*c == '.')
+                *c = locale_point;
+        s = buf;
+    }
+    const char* end = NULL;
+    if (out_double)
+    {
+        char* s_end = NULL;
+        *out_double = strtod(s, &s_end);
+        end = (s_end != s) ? src + (s_end - s) : NULL;
+    }
+    else
+    {
+        end = (sscanf(s, "%f", out_float) == 1) ? src : NULL;
+    }
+    if (buf != NULL && buf != local_buf)
+        IM_FREE(buf);
+    return end;
+}
+
+// Parse a decimal floating-point number as sscanf("%lf") would, accepting both '.' and the decimal point of the C locale (which vsnprintf() outputs).
+// Up to 15 significant digits with a power of ten exponent up to 22 are converted exactly with a single multiplication or division,
+// other numbers (and "inf", "nan", hexadecimal floats) are passed to strtod().
+static const char* ImParseDouble(const char* src, double* output)
+{
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    while (ImCharIsBlankA(*src))
+        src++;
+    const char locale_point = ImGetLocaleDecimalPoint();
+    const char* p = src;
+    const bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        p++;
+    const bool hexadecimal = (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')); // The loops below would stop on the 'x' and return 0
+    ImU64 mantissa = 0;
+    int mantissa_digits = 0;    // Significant digits, not counting leading zeroes
+    int exponent = 0;
+    bool has_digits = false;
+    for (; *p >= '0' && *p <= '9'; p++, has_digits = true)
+    {
+        if (mantissa_digits < 19)
+            mantissa = mantissa * 10 + (*p - '0');
+        else
+            exponent++;
+        if (mantissa != 0)
+            mantissa_digits++;
+    }
+    if (*p == '.' || *p == locale_point)
+        for (p++; *p >= '0' && *p <= '9'; p++, has_digits = true)
+        {
+            if (mantissa_digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+            if (mantissa != 0)
+                mantissa_digits++;
+        }
+    if (has_digits && (*p == 'e' || *p == 'E'))
+    {
+        const char* p_exp = p + 1;
+        const bool exp_negative = (*p_exp == '-');
+        if (*p_exp == '-' || *p_exp == '+')
+            p_exp++;
+        if (*p_exp >= '0' && *p_exp <= '9')
+        {
+            int exp_value = 0;
+            for (; *p_exp >= '0' && *p_exp <= '9'; p_exp++)
+                exp_value = ImMin(exp_value * 10 + (*p_exp - '0'), 100000);
+            exponent += exp_negative ? -exp_value : exp_value;
+            p = p_exp;
+        }
+    }
+    if (has_digits && !hexadecimal && mantissa_digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        const double v = (exponent < 0) ? (double)mantissa / pow10[-exponent] : (double)mantissa * pow10[exponent];
+        *output = negative ? -v : v;
+        return p;
+    }
+    return ImParseFloatingWithLocale(src, locale_point, output, NULL);
+}
+
+static const char* ImParseFloat(const char* src, float* output)
+{
+    double v;
+    const char* end = ImParseDouble(src, &v);
+    if (end == NULL)
+        return NULL;
+
+    // Converting to float rounds a second time: a double exactly halfway between two floats may come from a number which isn't, let sscanf() decide
+    ImU64 v_bits;
+    memcpy(&v_bits, &v, sizeof(v));
+    if ((v_bits & 0x1FFFFFFF) == 0x10000000)
+        return ImParseFloatingWithLocale(src, ImGetLocaleDecimalPoint(), NULL, output) ? end : NULL;
+    *output = (float)v;
+    return end;
+}
+
+// Parse the text of a value edited with 'format', as sscanf(buf, format) would. Floating-point values and integer formats without text
+// before the specifier, width or flags (e.g. "%d", "%u", "%lld") are parsed without sscanf(). Floating-point values accept both '.' and the decimal
+// point of the C locale, so values formatted by either IMGUI_USE_FAST_NUMBER_FORMAT or vsnprintf() can be edited back.
+// Integer values out of the range of the data type are clamped.
+static bool DataTypeParseText(const char* buf, ImGuiDataType data_type, void* data_ptr, const char* format)
+{
+    if (data_type == ImGuiDataType_Float)
+        return ImParseFloat(buf, (float*)data_ptr) != NULL;
+    if (data_type == ImGuiDataType_Double)
+        return ImParseDouble(buf, (double*)data_ptr) != NULL;
+
+    // Integers: check for a plain "%d" or "%u" with optional size modifier, sscanf() handles anything else (e.g. hexadecimal)
+    const char* p = format;
+    bool is_plain_format = (*p++ == '%');
+    if (p[0] == 'I' && p[1] == '6' && p[2] == '4')
+        p += 3;
+    else
+        while (*p == 'l' || *p == 'h')
+            p++;
+    is_plain_format &= (*p == 'd' || *p == 'u');
+
+    ImS64 v;
+    if (is_plain_format)
+    {
+        bool negative;
+        ImU64 magnitude;
+        if (!ImParseInteger(buf, &negative, &magnitude))
+            return false;
+        if (data_type == ImGuiDataType_U64)
+        {
+            *(ImU64*)data_ptr = negative ? 0 : magnitude;
+            return true;
+        }
+        if (negative)
+            v = (magnitude > (ImU64)IM_S64_MAX) ? IM_S64_MIN : -(ImS64)magnitude;
+        else
+            v = (magnitude > (ImU64)IM_S64_MAX) ? IM_S64_MAX : (ImS64)magnitude;
+    }
+    else
+    {
+        if (data_type == ImGuiDataType_S32 || data_type == ImGuiDataType_U32 || data_type == ImGuiDataType_S64 || data_type == ImGuiDataType_U64)
+            return sscanf(buf, format, data_ptr) == 1;
+        int v32; // Small types need a 32-bit buffer to receive the result from scanf()
+        if (sscanf(buf, format, &v32) != 1)
+            return false;
+        v = v32;
+    }
+
+    switch (data_type)
+    {
+    case ImGuiDataType_S8:  *(ImS8*)data_ptr  = (ImS8) ImClamp(v, (ImS64)IM_S8_MIN,  (ImS64)IM_S8_MAX);  break;
+    case ImGuiDataType_U8:  *(ImU8*)data_ptr  = (ImU8) ImClamp(v, (ImS64)IM_U8_MIN,  (ImS64)IM_U8_MAX);  break;
+    case ImGuiDataType_S16: *(ImS16*)data_ptr = (ImS16)ImClamp(v, (ImS64)IM_S16_MIN, (ImS64)IM_S16_MAX); break;
+    case ImGuiDataType_U16: *(ImU16*)data_ptr = (ImU16)ImClamp(v, (ImS64)IM_U16_MIN, (ImS64)IM_U16_MAX); break;
+    case ImGuiDataType_S32: *(ImS32*)data_ptr = (ImS32)ImClamp(v, (ImS64)IM_S32_MIN, (ImS64)IM_S32_MAX); break;
+    case ImGuiDataType_U32: *(ImU32*)data_ptr = (ImU32)ImClamp(v, (ImS64)IM_U32_MIN, (ImS64)IM_U32_MAX); break;
+    case ImGuiDataType_S64: *(ImS64*)data_ptr = v; break;
+    default: IM_ASSERT(0); return false;
+    }
+    return true;
+}
+
 // User can input math operators (e.g. +100) to edit a numerical values.
 // NB: This is _not_ a full expression evaluator. We should probably add one and replace this dumb mess..
 bool ImGui::DataTypeApplyOpFromText(const char* buf, const char* initial_value_buf, ImGuiDataType data_type, void* data_ptr, const char* format)
@@ -1791,13 +2048,13 @@ bool ImGui::DataTypeApplyOpFromText(const char* buf, const char* initial_value_b
         int* v = (int*)data_ptr;
         int arg0i = *v;
         float arg1f = 0.0f;
-        if (op && sscanf(initial_value_buf, format, &arg0i) < 1)
+        if (op && !DataTypeParseText(initial_value_buf, data_type, &arg0i, format))
             return false;
         // Store operand in a float so we can use fractional value for multipliers (*1.1), but constant always parsed as integer so we can fit big integers (e.g. 2000000003) past float precision
-        if (op == '+')      { if (sscanf(buf, "%d", &arg1i)) *v = (int)(arg0i + arg1i); }                   // Add (use "+-" to subtract)
-        else if (op == '*') { if (sscanf(buf, "%f", &arg1f)) *v = (int)(arg0i * arg1f); }                   // Multiply
-        else if (op == '/') { if (sscanf(buf, "%f", &arg1f) && arg1f != 0.0f) *v = (int)(arg0i / arg1f); }  // Divide
-        else                { if (sscanf(buf, format, &arg1i) == 1) *v = arg1i; }                           // Assign constant
+        if (op == '+')      { if (DataTypeParseText(buf, data_type, &arg1i, "%d")) *v = (int)(arg0i + arg1i); }                                // Add (use "+-" to subtract)
+        else if (op == '*') { if (DataTypeParseText(buf, ImGuiDataType_Float, &arg1f, "%f")) *v = (int)(arg0i * arg1f); }                   // Multiply
+        else if (op == '/') { if (DataTypeParseText(buf, ImGuiDataType_Float, &arg1f, "%f") && arg1f != 0.0f) *v = (int)(arg0i / arg1f); }  // Divide
+        else                { if (DataTypeParseText(buf, data_type, &arg1i, format)) *v = arg1i; }                                          // Assign constant
     }
     else if (data_type == ImGuiDataType_Float)
     {
@@ -1805,9 +2062,9 @@ bool ImGui::DataTypeApplyOpFromText(const char* buf, const char* initial_value_b
         format = "%f";
         float* v = (float*)data_ptr;
         float arg0f = *v, arg1f = 0.0f;
-        if (op && sscanf(initial_value_buf, format, &arg0f) < 1)
+        if (op && !DataTypeParseText(initial_value_buf, data_type, &arg0f, format))
             return false;
-        if (sscanf(buf, format, &arg1f) < 1)
+        if (!DataTypeParseText(buf, data_type, &arg1f, format))
             return false;
         if (op == '+')      { *v = arg0f + arg1f; }                    // Add (use "+-" to subtract)
         else if (op == '*') { *v = arg0f * arg1f; }                    // Multiply
@@ -1819,36 +2076,20 @@ bool ImGui::DataTypeApplyOpFromText(const char* buf, const char* initial_value_b
         format = "%lf"; // scanf differentiate float/double unlike printf which forces everything to double because of ellipsis
         double* v = (double*)data_ptr;
         double arg0f = *v, arg1f = 0.0;
-        if (op && sscanf(initial_value_buf, format, &arg0f) < 1)
+        if (op && !DataTypeParseText(initial_value_buf, data_type, &arg0f, format))
             return false;
-        if (sscanf(buf, format, &arg1f) < 1)
+        if (!DataTypeParseText(buf, data_type, &arg1f, format))
             return false;
         if (op == '+')      { *v = arg0f + arg1f; }                    // Add (use "+-" to subtract)
         else if (op == '*') { *v = arg0f * arg1f; }                    // Multiply
         else if (op == '/') { if (arg1f != 0.0f) *v = arg0f / arg1f; } // Divide
         else                { *v = arg1f; }                            // Assign constant
     }
-    else if (data_type == ImGuiDataType_U32 || data_type == ImGuiDataType_S64 || data_type == ImGuiDataType_U64)
+    else
     {
         // All other types assign constant
         // We don't bother handling support for legacy operators since they are a little too crappy. Instead we will later implement a proper expression evaluator in the future.
-        sscanf(buf, format, data_ptr);
-    }
-    else
-    {
-        // Small types need a 32-bit buffer to receive the result from scanf()
-        int v32;
-        sscanf(buf, format, &v32);
-        if (data_type == ImGuiDataType_S8)
-            *(ImS8*)data_ptr = (ImS8)ImClamp(v32, (int)IM_S8_MIN, (int)IM_S8_MAX);
-        else if (data_type == ImGuiDataType_U8)
-            *(ImU8*)data_ptr = (ImU8)ImClamp(v32, (int)IM_U8_MIN, (int)IM_U8_MAX);
-        else if (data_type == ImGuiDataType_S16)
-            *(ImS16*)data_ptr = (ImS16)ImClamp(v32, (int)IM_S16_MIN, (int)IM_S16_MAX);
-        else if (data_type == ImGuiDataType_U16)
-            *(ImU16*)data_ptr = (ImU16)ImClamp(v32, (int)IM_U16_MIN, (int)IM_U16_MAX);
-        else
-            IM_ASSERT(0);
+        DataTypeParseText(buf, data_type, data_ptr, format);
     }
 
     return memcmp(data_backup, data_ptr, type_info->Size) != 0;
@@ -3084,19 +3325,50 @@ bool ImGui::InputTextWithHint(const char* label, const char* hint, char* buf, si
 
 static int InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end)
 {
-    int line_count = 0;
-    const char* s = text_begin;
-    while (char c = *s++) // We are only matching for \n so we can ignore UTF-8 decoding
-        if (c == '\n')
-            line_count++;
-    s--;
-    if (s[0] != '\n' && s[0] != '\r')
+    const char* text_end = text_begin + strlen(text_begin);
+    int line_count = 1;
+    for (const char* s = text_begin; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++) // We are only matching for \n so we can ignore UTF-8 decoding
         line_count++;
-    *out_text_end = s;
+    *out_text_end = text_end;
     return line_count;
 }
 
-static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining, ImVec2* out_offset, bool stop_on_new_line)
+// Decode a character of the edit buffer. Contrary to ImTextCharFromUtf8() this always moves forward: invalid bytes are decoded as U+FFFD.
+static inline int InputTextCharFromUtf8(unsigned int* out_char, const char* text, const char* text_end)
+{
+    if (!(*text & 0x80))
+    {
+        *out_char = (unsigned char)*text;
+        return 1;
+    }
+    const int len = ImTextCharFromUtf8(out_char, text, text_end);
+    if (len == 0)
+    {
+        *out_char = IM_UNICODE_CODEPOINT_INVALID;
+        return 1;
+    }
+    return len;
+}
+
+// Length of the text we accept from the end-user buffer: we cut off at the first invalid UTF-8 byte, like ImTextStrFromUtf8() and text rendering do.
+static int InputTextCalcValidUtf8Len(const char* text, const char* text_end)
+{
+    const char* s = text;
+    while (s < text_end)
+    {
+        s = ImTextFindNonAscii(s, text_end, 1);
+        if (s == text_end)
+            break;
+        unsigned int c;
+        const int len = ImTextCharFromUtf8(&c, s, text_end);
+        if (c == 0)
+            break;
+        s += len;
+    }
+    return (int)(s - text);
+}
+
+static ImVec2 InputTextCalcTextSize(const char* text_begin, const char* text_end, const char** remaining, ImVec2* out_offset, bool stop_on_new_line)
 {
     ImGuiContext& g = *GImGui;
     ImFont* font = g.Font;
@@ -3105,16 +3377,19 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
 
     ImVec2 text_size = ImVec2(0,0);
     float line_width = 0.0f;
+    ImWchar prev_c = 0;
 
-    const ImWchar* s = text_begin;
+    const char* s = text_begin;
     while (s < text_end)
     {
-        unsigned int c = (unsigned int)(*s++);
+        unsigned int c;
+        s += InputTextCharFromUtf8(&c, s, text_end);
         if (c == '\n')
         {
             text_size.x = ImMax(text_size.x, line_width);
             text_size.y += line_height;
             line_width = 0.0f;
+            prev_c = 0;
             if (stop_on_new_line)
                 break;
             continue;
@@ -3122,8 +3397,9 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
         if (c == '\r')
             continue;
 
-        const float char_width = font->GetCharAdvance((ImWchar)c) * scale;
+        const float char_width = (font->GetCharAdvance((ImWchar)c) + font->GetKerningAdvance(prev_c, (ImWchar)c)) * scale;
         line_width += char_width;
+        prev_c = (ImWchar)c;
     }
 
     if (text_size.x < line_width)
@@ -3141,20 +3417,37 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
     return text_size;
 }
 
-// Wrapper for stb_textedit.h to edit text (our wrapper is for: statically sized buffer, single-line, wchar characters. InputText converts between UTF-8 and wchar)
+// Wrapper for stb_textedit.h to edit text (our wrapper is for: statically sized buffer, single-line, UTF-8 characters. Positions are byte offsets)
 namespace ImStb
 {
 
-static int     STB_TEXTEDIT_STRINGLEN(const STB_TEXTEDIT_STRING* obj)                             { return obj->CurLenW; }
-static ImWchar STB_TEXTEDIT_GETCHAR(const STB_TEXTEDIT_STRING* obj, int idx)                      { return obj->TextW[idx]; }
-static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)  { ImWchar c = obj->TextW[line_start_idx + char_idx]; if (c == '\n') return STB_TEXTEDIT_GETWIDTH_NEWLINE; ImGuiContext& g = *GImGui; return g.Font->GetCharAdvance(c) * (g.FontSize / g.Font->FontSize); }
-static int     STB_TEXTEDIT_KEYTOTEXT(int key)                                                    { return key >= 0x10000 ? 0 : key; }
-static ImWchar STB_TEXTEDIT_NEWLINE = '\n';
+static int     STB_TEXTEDIT_STRINGLEN(const STB_TEXTEDIT_STRING* obj)                             { return obj->CurLenA; }
+static char    STB_TEXTEDIT_GETCHAR(const STB_TEXTEDIT_STRING* obj, int idx)                      { return obj->TextA[idx]; }
+static int     STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL(const STB_TEXTEDIT_STRING* obj, int idx)        { unsigned int c; return idx + InputTextCharFromUtf8(&c, obj->TextA.Data + idx, obj->TextA.Data + obj->CurLenA); }
+static int     STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(const STB_TEXTEDIT_STRING* obj, int idx)        { const char* text = obj->TextA.Data; int prev = idx - 1; while (prev > 0 && prev > idx - 4 && (text[prev] & 0xC0) == 0x80) prev--; return prev; } // Skip continuation bytes
+#define STB_TEXTEDIT_GETNEXTCHARINDEX  STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL    // They need to be #define for stb_textedit.h
+#define STB_TEXTEDIT_GETPREVCHARINDEX  STB_TEXTEDIT_GETPREVCHARINDEX_IMPL
+static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)
+{
+    const char* text = obj->TextA.Data;
+    const char* text_end = text + obj->CurLenA;
+    unsigned int c;
+    InputTextCharFromUtf8(&c, text + line_start_idx + char_idx, text_end);
+    if (c == '\n')
+        return STB_TEXTEDIT_GETWIDTH_NEWLINE;
+    ImGuiContext& g = *GImGui;
+    unsigned int prev_c = 0; // Kerning with the previous character of the same line
+    if (char_idx > 0)
+        InputTextCharFromUtf8(&prev_c, text + STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(obj, line_start_idx + char_idx), text_end);
+    return (g.Font->GetCharAdvance((ImWchar)c) + g.Font->GetKerningAdvance((ImWchar)prev_c, (ImWchar)c)) * (g.FontSize / g.Font->FontSize);
+}
+static int     STB_TEXTEDIT_KEYTOTEXT(int key)                                                    { return key >= 0x200000 ? 0 : key; }
+static char    STB_TEXTEDIT_NEWLINE = '\n';
 static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, STB_TEXTEDIT_STRING* obj, int line_start_idx)
 {
-    const ImWchar* text = obj->TextW.Data;
-    const ImWchar* text_remaining = NULL;
-    const ImVec2 size = InputTextCalcTextSizeW(text + line_start_idx, text + obj->CurLenW, &text_remaining, NULL, true);
+    const char* text = obj->TextA.Data;
+    const char* text_remaining = NULL;
+    const ImVec2 size = InputTextCalcTextSize(text + line_start_idx, text + obj->CurLenA, &text_remaining, NULL, true);
     r->x0 = 0.0f;
     r->x1 = size.x;
     r->baseline_y_delta = size.y;
@@ -3164,59 +3457,77 @@ static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, STB_TEXTEDIT_STRING* ob
 }
 
 static bool is_separator(unsigned int c)                                        { return ImCharIsBlankW(c) || c==',' || c==';' || c=='(' || c==')' || c=='{' || c=='}' || c=='[' || c==']' || c=='|'; }
-static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator( obj->TextW[idx-1] ) && !is_separator( obj->TextW[idx] ) ) : 1; }
-static int  STB_TEXTEDIT_MOVEWORDLEFT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)   { idx--; while (idx >= 0 && !is_word_boundary_from_right(obj, idx)) idx--; return idx < 0 ? 0 : idx; }
+static bool is_separator_at(STB_TEXTEDIT_STRING* obj, int idx)                  { unsigned int c; InputTextCharFromUtf8(&c, obj->TextA.Data + idx, obj->TextA.Data + obj->CurLenA); return is_separator(c); }
+static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator_at(obj, STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(obj, idx)) && !is_separator_at(obj, idx) ) : 1; }
+static int  STB_TEXTEDIT_MOVEWORDLEFT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)   { if (idx <= 0) return 0; idx = STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(obj, idx); while (idx > 0 && !is_word_boundary_from_right(obj, idx)) idx = STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(obj, idx); return idx; }
 #ifdef __APPLE__    // FIXME: Move setting to IO structure
-static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator( obj->TextW[idx-1] ) && is_separator( obj->TextW[idx] ) ) : 1; }
-static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_left(obj, idx)) idx++; return idx > len ? len : idx; }
+static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator_at(obj, STB_TEXTEDIT_GETPREVCHARINDEX_IMPL(obj, idx)) && is_separator_at(obj, idx) ) : 1; }
+static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { int len = obj->CurLenA; if (idx >= len) return len; idx = STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL(obj, idx); while (idx < len && !is_word_boundary_from_left(obj, idx)) idx = STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL(obj, idx); return idx > len ? len : idx; }
 #else
-static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_right(obj, idx)) idx++; return idx > len ? len : idx; }
+static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { int len = obj->CurLenA; if (idx >= len) return len; idx = STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL(obj, idx); while (idx < len && !is_word_boundary_from_right(obj, idx)) idx = STB_TEXTEDIT_GETNEXTCHARINDEX_IMPL(obj, idx); return idx > len ? len : idx; }
 #endif
 #define STB_TEXTEDIT_MOVEWORDLEFT   STB_TEXTEDIT_MOVEWORDLEFT_IMPL    // They need to be #define for stb_textedit.h
 #define STB_TEXTEDIT_MOVEWORDRIGHT  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL
 
-static void STB_TEXTEDIT_DELETECHARS(STB_TEXTEDIT_STRING* obj, int pos, int n)
+// Rows are lines of constant height, so we can use our line index instead of laying out every row from the start of the text
+static int  STB_TEXTEDIT_FIND_ROW_FROM_CHAR_IMPL(STB_TEXTEDIT_STRING* obj, int n, int* out_prev_row_start, float* out_row_y)
+{
+    obj->UpdateLineIndex();
+    const int line_no = obj->FindLineNo(n);
+    *out_prev_row_start = (line_no > 0) ? obj->LineStarts[line_no - 1] : 0;
+    *out_row_y = line_no * GImGui->FontSize;
+    return obj->LineStarts[line_no];
+}
+static int  STB_TEXTEDIT_FIND_ROW_FROM_Y_IMPL(STB_TEXTEDIT_STRING* obj, float y, float* out_row_y)
 {
-    ImWchar* dst = obj->TextW.Data + pos;
+    obj->UpdateLineIndex();
+    const float line_height = GImGui->FontSize;
+    int line_no = (y > 0.0f) ? ImMin((int)(y / line_height), obj->LineStarts.Size - 1) : 0;
+    if (line_no > 0 && y < line_no * line_height)
+        line_no--;
+    *out_row_y = line_no * line_height;
+    return obj->LineStarts[line_no];
+}
+#define STB_TEXTEDIT_FIND_ROW_FROM_CHAR STB_TEXTEDIT_FIND_ROW_FROM_CHAR_IMPL
+#define STB_TEXTEDIT_FIND_ROW_FROM_Y    STB_TEXTEDIT_FIND_ROW_FROM_Y_IMPL
 
-    // We maintain our buffer length in both UTF-8 and wchar formats
-    obj->CurLenA -= ImTextCountUtf8BytesFromStr(dst, dst + n);
-    obj->CurLenW -= n;
+static void STB_TEXTEDIT_DELETECHARS(STB_TEXTEDIT_STRING* obj, int pos, int n)
+{
+    obj->LineIndexDelete(pos, n);
 
-    // Offset remaining text (FIXME-OPT: Use memmove)
-    const ImWchar* src = obj->TextW.Data + pos + n;
-    while (ImWchar c = *src++)
-        *dst++ = c;
-    *dst = '\0';
+    // Offset remaining text (including zero-terminator)
+    char* dst = obj->TextA.Data + pos;
+    memmove(dst, dst + n, (size_t)(obj->CurLenA - pos - n + 1));
+    obj->CurLenA -= n;
 }
 
-static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const ImWchar* new_text, int new_text_len)
+static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const char* new_text, int new_text_len)
 {
     const bool is_resizable = (obj->UserFlags & ImGuiInputTextFlags_CallbackResize) != 0;
-    const int text_len = obj->CurLenW;
+    const int text_len = obj->CurLenA;
     IM_ASSERT(pos <= text_len);
 
-    const int new_text_len_utf8 = ImTextCountUtf8BytesFromStr(new_text, new_text + new_text_len);
-    if (!is_resizable && (new_text_len_utf8 + obj->CurLenA + 1 > obj->BufCapacityA))
+    if (!is_resizable && (new_text_len + text_len + 1 > obj->BufCapacityA))
         return false;
 
     // Grow internal buffer if needed
-    if (new_text_len + text_len + 1 > obj->TextW.Size)
+    if (new_text_len + text_len + 1 > obj->TextA.Size)
     {
         if (!is_resizable)
             return false;
-        IM_ASSERT(text_len < obj->TextW.Size);
-        obj->TextW.resize(text_len + ImClamp(new_text_len * 4, 32, ImMax(256, new_text_len)) + 1);
+        IM_ASSERT(text_len < obj->TextA.Size);
+        obj->TextA.resize(ImMax(text_len + ImClamp(new_text_len * 4, 32, ImMax(256, new_text_len)) + 1, obj->TextA.Size + obj->TextA.Size / 2)); // Grow geometrically so repeated large insertions don't copy the text every time
     }
 
-    ImWchar* text = obj->TextW.Data;
+    obj->LineIndexInsert(pos, new_text, new_text_len);
+
+    char* text = obj->TextA.Data;
     if (pos != text_len)
-        memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos) * sizeof(ImWchar));
-    memcpy(text + pos, new_text, (size_t)new_text_len * sizeof(ImWchar));
+        memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos));
+    memcpy(text + pos, new_text, (size_t)new_text_len);
 
-    obj->CurLenW += new_text_len;
-    obj->CurLenA += new_text_len_utf8;
-    obj->TextW[obj->CurLenW] = '\0';
+    obj->CurLenA += new_text_len;
+    obj->TextA[obj->CurLenA] = '\0';
 
     return true;
 }
@@ -3241,22 +3552,278 @@ static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const Im
 #define STB_TEXTEDIT_IMPLEMENTATION
 #include "imstb_textedit.h"
 
+// Undo system (STB_TEXTEDIT_UNDOSTATE = ImGuiInputTextUndoState)
+// An undo record deletes DeleteLen bytes at Where then inserts back the InsertLen bytes it stores. Applying it creates the opposite record on the other stack.
+static void stb_text_clearundo(STB_TexteditState* state)
+{
+    // Called when a new widget is activated: release the storage, it is allocated again on the first edit.
+    state->undostate.ClearFreeMemory();
+}
+
+// Create an undo record and return storage for its insert_len bytes. Return NULL if it doesn't fit in the budget.
+static char* InputTextUndoCreateRecord(ImGuiInputTextUndoState* s, int where, int insert_len, int delete_len, int merge_kind)
+{
+    s->RedoStack.Clear();
+    if (sizeof(ImGuiInputTextUndoRecord) + (size_t)insert_len > GImGui->IO.ConfigInputTextUndoBudget)
+    {
+        // Older records can't be applied without this one, so the whole history is lost
+        s->UndoStack.Clear();
+        return NULL;
+    }
+    return s->UndoStack.Push(where, insert_len, delete_len, merge_kind);
+}
+
+static void stb_text_makeundo_insert(STB_TexteditState* state, int where, int length)
+{
+    ImGuiInputTextUndoState* s = &state->undostate;
+    ImGuiInputTextUndoRecord* last = (s->UndoStack.GetCount() > 0) ? &s->UndoStack.Records.back() : NULL;
+    if (last && s->NextMergeKind == ImGuiInputTextUndoMerge_Typing && last->MergeKind == ImGuiInputTextUndoMerge_Typing && last->Where + last->DeleteLen == where)
+    {
+        // Extend the current run of typed characters
+        s->RedoStack.Clear();
+        last->DeleteLen += length;
+    }
+    else
+    {
+        InputTextUndoCreateRecord(s, where, 0, length, (s->NextMergeKind == ImGuiInputTextUndoMerge_Typing) ? ImGuiInputTextUndoMerge_Typing : ImGuiInputTextUndoMerge_None);
+    }
+    s->TrimToBudget(GImGui->IO.ConfigInputTextUndoBudget);
+}
+
+static void stb_text_makeundo_delete(STB_TEXTEDIT_STRING* str, STB_TexteditState* state, int where, int length)
+{
+    ImGuiInputTextUndoState* s = &state->undostate;
+    ImGuiInputTextUndoStack* stack = &s->UndoStack;
+    ImGuiInputTextUndoRecord* last = (stack->GetCount() > 0) ? &stack->Records.back() : NULL;
+    if (last && s->NextMergeKind == ImGuiInputTextUndoMerge_Deleting && last->MergeKind == ImGuiInputTextUndoMerge_Deleting && (where + length == last->Where || where == last->Where))
+    {
+        // Extend the current run of deleted characters: Backspace prepends to the stored bytes, Delete appends to them.
+        // The record is the last one so its bytes are at the end of Chars[].
+        s->RedoStack.Clear();
+        const int offset = (where == last->Where) ? last->InsertLen : 0;
+        stack->Chars.resize(stack->Chars.Size + length);
+        char* p = stack->Chars.Data + last->CharStorage;
+        memmove(p + offset + length, p + offset, (size_t)(last->InsertLen - offset));
+        memcpy(p + offset, str->TextA.Data + where, (size_t)length);
+        last->Where = where;
+        last->InsertLen += length;
+    }
+    else if (char* p = InputTextUndoCreateRecord(s, where, length, 0, (s->NextMergeKind == ImGuiInputTextUndoMerge_Deleting) ? ImGuiInputTextUndoMerge_Deleting : ImGuiInputTextUndoMerge_None))
+    {
+        memcpy(p, str->TextA.Data + where, (size_t)length);
+    }
+    s->TrimToBudget(GImGui->IO.ConfigInputTextUndoBudget);
+}
+
+static void stb_text_makeundo_replace(STB_TEXTEDIT_STRING* str, STB_TexteditState* state, int where, int old_length, int new_length)
+{
+    ImGuiInputTextUndoState* s = &state->undostate;
+    if (char* p = InputTextUndoCreateRecord(s, where, old_length, new_length, ImGuiInputTextUndoMerge_None))
+        memcpy(p, str->TextA.Data + where, (size_t)old_length);
+    s->TrimToBudget(GImGui->IO.ConfigInputTextUndoBudget);
+}
+
+// Apply the last record of 'src' and push the opposite record onto 'dst'. Return false if the record doesn't match the text.
+static bool InputTextUndoApplyRecord(STB_TEXTEDIT_STRING* str, STB_TexteditState* state, ImGuiInputTextUndoStack* src, ImGuiInputTextUndoStack* dst)
+{
+    const ImGuiInputTextUndoRecord rec = src->Records.back();
+    if (rec.Where + rec.DeleteLen > str->CurLenA)
+        return false; // The text was modified without going through stb_textedit (e.g. from a callback)
+
+    // Check that the insertion will succeed before deleting anything, so we never leave a half-applied record (same limits as STB_TEXTEDIT_INSERTCHARS)
+    const int new_len = str->CurLenA - rec.DeleteLen + rec.InsertLen;
+    if (!(str->UserFlags & ImGuiInputTextFlags_CallbackResize) && (new_len + 1 > str->BufCapacityA || new_len + 1 > str->TextA.Size))
+        return false;
+
+    char* p = dst->Push(rec.Where, rec.DeleteLen, rec.InsertLen, ImGuiInputTextUndoMerge_None);
+    if (rec.DeleteLen > 0)
+    {
+        memcpy(p, str->TextA.Data + rec.Where, (size_t)rec.DeleteLen);
+        STB_TEXTEDIT_DELETECHARS(str, rec.Where, rec.DeleteLen);
+    }
+    if (rec.InsertLen > 0 && !STB_TEXTEDIT_INSERTCHARS(str, rec.Where, src->Chars.Data + rec.CharStorage, rec.InsertLen))
+        return false;
+
+    src->Records.pop_back();
+    src->Chars.resize(rec.CharStorage);
+    if (src->GetCount() == 0)
+        src->Clear();
+    state->cursor = rec.Where + rec.InsertLen;
+    return true;
+}
+
+static void stb_text_undo(STB_TEXTEDIT_STRING* str, STB_TexteditState* state)
+{
+    ImGuiInputTextUndoState* s = &state->undostate;
+    if (s->UndoStack.GetCount() == 0)
+        return;
+    if (!InputTextUndoApplyRecord(str, state, &s->UndoStack, &s->RedoStack))
+        s->Clear();
+    else if (!s->TrimToBudget(GImGui->IO.ConfigInputTextUndoBudget))
+        s->RedoStack.Clear();
+}
+
+static void stb_text_redo(STB_TEXTEDIT_STRING* str, STB_TexteditState* state)
+{
+    ImGuiInputTextUndoState* s = &state->undostate;
+    if (s->RedoStack.GetCount() == 0)
+        return;
+    if (!InputTextUndoApplyRecord(str, state, &s->RedoStack, &s->UndoStack))
+        s->Clear();
+    else
+        s->TrimToBudget(GImGui->IO.ConfigInputTextUndoBudget);
+}
+
+}
+
+char* ImGuiInputTextUndoStack::Push(int where, int insert_len, int delete_len, int merge_kind)
+{
+    ImGuiInputTextUndoRecord rec;
+    rec.Where = where;
+    rec.InsertLen = insert_len;
+    rec.DeleteLen = delete_len;
+    rec.CharStorage = Chars.Size;
+    rec.MergeKind = merge_kind;
+    Records.push_back(rec);
+    Chars.resize(Chars.Size + insert_len);
+    return Chars.Data + rec.CharStorage;
+}
+
+void ImGuiInputTextUndoStack::DiscardFirst()
+{
+    IM_ASSERT(GetCount() > 0);
+    CharsFirst += Records[RecordsFirst].InsertLen;
+    RecordsFirst++;
+    if (RecordsFirst == Records.Size)
+    {
+        Clear();
+        return;
+    }
+
+    // Compact once the discarded storage exceeds the remaining one, so discarding is amortized O(1)
+    if ((size_t)RecordsFirst * sizeof(ImGuiInputTextUndoRecord) + (size_t)CharsFirst < GetBytes())
+        return;
+    const int records_count = GetCount();
+    const int chars_count = Chars.Size - CharsFirst;
+    for (int n = RecordsFirst; n < Records.Size; n++)
+        Records[n].CharStorage -= CharsFirst;
+    memmove(Records.Data, Records.Data + RecordsFirst, (size_t)records_count * sizeof(ImGuiInputTextUndoRecord));
+    memmove(Chars.Data, Chars.Data + CharsFirst, (size_t)chars_count);
+    Records.resize(records_count);
+    Chars.resize(chars_count);
+    RecordsFirst = CharsFirst = 0;
+}
+
+bool ImGuiInputTextUndoState::TrimToBudget(size_t budget)
+{
+    while (UndoStack.GetBytes() + RedoStack.GetBytes() > budget && UndoStack.GetCount() > 0)
+        UndoStack.DiscardFirst();
+    return UndoStack.GetBytes() + RedoStack.GetBytes() <= budget;
 }
 
 void ImGuiInputTextState::OnKeyPressed(int key)
 {
+    // Merge runs of characters deleted with Backspace/Delete into a single undo record
+    const int key_without_mods = key & ~STB_TEXTEDIT_K_SHIFT;
+    if ((key_without_mods == STB_TEXTEDIT_K_BACKSPACE || key_without_mods == STB_TEXTEDIT_K_DELETE) && !HasSelection())
+        Stb.undostate.NextMergeKind = ImGuiInputTextUndoMerge_Deleting;
     stb_textedit_key(this, &Stb, key);
+    Stb.undostate.NextMergeKind = ImGuiInputTextUndoMerge_None;
     CursorFollow = true;
     CursorAnimReset();
 }
 
+void ImGuiInputTextState::OnCharPressed(unsigned int c)
+{
+    // Convert the character to a UTF-8 byte sequence
+    char utf8[5];
+    const ImWchar wc = (ImWchar)c;
+    const int utf8_len = ImTextStrToUtf8(utf8, IM_ARRAYSIZE(utf8), &wc, &wc + 1);
+
+    // Merge runs of typed characters into a single undo record, starting a new one at the first blank following a word
+    const bool is_blank = (c == '\n' || ImCharIsBlankW(c));
+    const bool prev_is_blank = (Stb.cursor > 0 && Stb.cursor <= CurLenA && (TextA[Stb.cursor - 1] == '\n' || ImCharIsBlankA(TextA[Stb.cursor - 1])));
+    if (is_blank && !prev_is_blank)
+        Stb.undostate.DisableMerge();
+    Stb.undostate.NextMergeKind = ImGuiInputTextUndoMerge_Typing;
+    stb_textedit_text(this, &Stb, utf8, utf8_len);
+    Stb.undostate.NextMergeKind = ImGuiInputTextUndoMerge_None;
+    CursorFollow = true;
+    CursorAnimReset();
+}
+
+void ImGuiInputTextState::UpdateLineIndex()
+{
+    if (LineStarts.Size > 0)
+        return;
+    LineStarts.push_back(0);
+    const char* text = TextA.Data;
+    const char* text_end = text + CurLenA;
+    for (const char* s = text; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++)
+        LineStarts.push_back((int)(s + 1 - text));
+}
+
+int ImGuiInputTextState::FindLineNo(int pos) const
+{
+    IM_ASSERT(LineStarts.Size > 0);
+    int lo = 0, hi = LineStarts.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) >> 1;
+        if (LineStarts[mid] <= pos)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+// Called by STB_TEXTEDIT_INSERTCHARS() before inserting into TextA
+void ImGuiInputTextState::LineIndexInsert(int pos, const char* text, int text_len)
+{
+    if (LineStarts.Size == 0)
+        return;
+    const int line_no = FindLineNo(pos);
+    for (int n = line_no + 1; n < LineStarts.Size; n++)
+        LineStarts[n] += text_len;
+
+    // Insert new lines in one go, pasting many lines would be quadratic otherwise
+    const char* text_end = text + text_len;
+    int new_lines_count = 0;
+    for (const char* s = text; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++)
+        new_lines_count++;
+    if (new_lines_count == 0)
+        return;
+    const int insert_at = line_no + 1;
+    const int old_size = LineStarts.Size;
+    LineStarts.resize(old_size + new_lines_count);
+    memmove(LineStarts.Data + insert_at + new_lines_count, LineStarts.Data + insert_at, (size_t)(old_size - insert_at) * sizeof(int));
+    int* out_line = LineStarts.Data + insert_at;
+    for (const char* s = text; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++)
+        *out_line++ = pos + (int)(s + 1 - text);
+}
+
+// Called by STB_TEXTEDIT_DELETECHARS()
+void ImGuiInputTextState::LineIndexDelete(int pos, int len)
+{
+    if (LineStarts.Size == 0)
+        return;
+    const int line_no = FindLineNo(pos);
+    int removed_end = line_no + 1;
+    while (removed_end < LineStarts.Size && LineStarts[removed_end] <= pos + len)
+        removed_end++;
+    if (removed_end > line_no + 1)
+        LineStarts.erase(LineStarts.Data + line_no + 1, LineStarts.Data + removed_end);
+    for (int n = line_no + 1; n < LineStarts.Size; n++)
+        LineStarts[n] -= len;
+}
+
 ImGuiInputTextCallbackData::ImGuiInputTextCallbackData()
 {
     memset(this, 0, sizeof(*this));
 }
 
 // Public API to manipulate UTF-8 text
-// We expose UTF-8 to the user (unlike the STB_TEXTEDIT_* functions which are manipulating wchar)
 // FIXME: The existence of this rarely exercised code path is a bit of a nuisance.
 void ImGuiInputTextCallbackData::DeleteChars(int pos, int bytes_count)
 {
@@ -3285,13 +3852,13 @@ void ImGuiInputTextCallbackData::InsertChars(int pos, const char* new_text, cons
         if (!is_resizable)
             return;
 
-        // Contrary to STB_TEXTEDIT_INSERTCHARS() this is working in the UTF8 buffer, hence the midly similar code (until we remove the U16 buffer alltogether!)
+        // Mildly similar to STB_TEXTEDIT_INSERTCHARS(), but working on the callback data
         ImGuiContext& g = *GImGui;
         ImGuiInputTextState* edit_state = &g.InputTextState;
         IM_ASSERT(edit_state->ID != 0 && g.ActiveId == edit_state->ID);
         IM_ASSERT(Buf == edit_state->TextA.Data);
         int new_buf_size = BufTextLen + ImClamp(new_text_len * 4, 32, ImMax(256, new_text_len)) + 1;
-        edit_state->TextA.reserve(new_buf_size + 1);
+        edit_state->TextA.resize(new_buf_size + 1);
         Buf = edit_state->TextA.Data;
         BufSize = edit_state->BufCapacityA = new_buf_size;
     }
@@ -3308,6 +3875,30 @@ void ImGuiInputTextCallbackData::InsertChars(int pos, const char* new_text, cons
     BufTextLen += new_text_len;
 }
 
+// Return the offset of the first byte where 'buf' differs from 'text' (zero-terminator included), or -1 if they are identical.
+// Only the first 'buf_size' bytes of 'buf' are read. Compare in blocks so large unchanged prefixes are skipped with memcmp().
+static int InputTextFindFirstDifference(const char* text, int text_len, const char* buf, int buf_size)
+{
+    const int len = ImMin(text_len + 1, buf_size);
+    const int BLOCK_SIZE = 256;
+    int offset = 0;
+    while (offset + BLOCK_SIZE <= len && memcmp(text + offset, buf + offset, BLOCK_SIZE) == 0)
+        offset += BLOCK_SIZE;
+    for (; offset < len; offset++)
+        if (text[offset] != buf[offset])
+            return offset;
+    return (len == text_len + 1) ? -1 : len;
+}
+
+static void InputTextAppendChars(ImVector<char>* buf, const char* text, const char* text_end)
+{
+    const int len = (int)(text_end - text);
+    if (len <= 0)
+        return;
+    buf->resize(buf->Size + len);
+    memcpy(buf->Data + buf->Size - len, text, (size_t)len);
+}
+
 // Return false to discard a character.
 static bool InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data)
 {
@@ -3376,8 +3967,7 @@ static bool InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags f
 //   Note that in std::string world, capacity() would omit 1 byte used by the zero-terminator.
 // - When active, hold on a privately held copy of the text (and apply back to 'buf'). So changing 'buf' while the InputText is active has no effect.
 // - If you want to use ImGui::InputText() with std::string, see misc/cpp/imgui_stdlib.h
-// (FIXME: Rather confusing and messy function, among the worse part of our codebase, expecting to rewrite a V2 at some point.. Partly because we are
-//  doing UTF8 > U16 > UTF8 conversions on the go to easily interface with stb_textedit. Ideally should stay in UTF-8 all the time. See https://github.com/nothings/stb/issues/188)
+// (FIXME: Rather confusing and messy function, among the worse part of our codebase, expecting to rewrite a V2 at some point..)
 bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* callback_user_data)
 {
     ImGuiWindow* window = GetCurrentWindow();
@@ -3462,22 +4052,21 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         state = &g.InputTextState;
         state->CursorAnimReset();
 
-        // Take a copy of the initial buffer value (both in original UTF-8 format and converted to wchar)
+        // Take a copy of the initial buffer value
         // From the moment we focused we are ignoring the content of 'buf' (unless we are in read-only mode)
         const int buf_len = (int)strlen(buf);
         state->InitialTextA.resize(buf_len + 1);    // UTF-8. we use +1 to make sure that .Data is always pointing to at least an empty string.
         memcpy(state->InitialTextA.Data, buf, buf_len + 1);
 
         // Start edition
-        const char* buf_end = NULL;
-        state->TextW.resize(buf_size + 1);          // wchar count <= UTF-8 count. we use +1 to make sure that .Data is always pointing to at least an empty string.
-        state->TextA.resize(0);
-        state->TextAIsValid = false;                // TextA is not valid yet (we will display buf until then)
-        state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, buf_size, buf, NULL, &buf_end);
-        state->CurLenA = (int)(buf_end - buf);      // We can't get the result from ImStrncpy() above because it is not UTF-8 aware. Here we'll cut off malformed UTF-8.
+        state->TextA.resize(ImMax(buf_size, buf_len + 1) + 1); // we use +1 to make sure that .Data is always pointing to at least an empty string.
+        state->CurLenA = InputTextCalcValidUtf8Len(buf, buf + buf_len); // Here we'll cut off malformed UTF-8.
+        memcpy(state->TextA.Data, buf, (size_t)state->CurLenA);
+        state->TextA[state->CurLenA] = 0;
+        state->OnTextReplaced();
 
         // Preserve cursor position and undo/redo stack if we come back to same widget
-        // FIXME: For non-readonly widgets we might be able to require that TextAIsValid && TextA == buf ? (untested) and discard undo stack if user buffer has changed.
+        // FIXME: For non-readonly widgets we might be able to require that TextA == buf ? (untested) and discard undo stack if user buffer has changed.
         const bool recycle_state = (state->ID == id);
         if (recycle_state)
         {
@@ -3528,19 +4117,25 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
     bool enter_pressed = false;
 
     // When read-only we always use the live data passed to the function
-    // FIXME-OPT: Because our selection/cursor code currently needs the wide text we need to convert it when active, which is not ideal :(
+    // Our selection/cursor code works on TextA so we copy it when it changed (keeping the line index otherwise)
     if (is_readonly && state != NULL && (render_cursor || render_selection))
     {
-        const char* buf_end = NULL;
-        state->TextW.resize(buf_size + 1);
-        state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, state->TextW.Size, buf, NULL, &buf_end);
-        state->CurLenA = (int)(buf_end - buf);
+        const int buf_len = (int)strlen(buf);
+        const int buf_valid_len = InputTextCalcValidUtf8Len(buf, buf + buf_len);
+        if (buf_valid_len != state->CurLenA || memcmp(state->TextA.Data, buf, (size_t)buf_valid_len) != 0)
+        {
+            state->TextA.resize(ImMax(state->TextA.Size, buf_valid_len + 1));
+            memcpy(state->TextA.Data, buf, (size_t)buf_valid_len);
+            state->TextA[buf_valid_len] = 0;
+            state->CurLenA = buf_valid_len;
+            state->OnTextReplaced();
+        }
         state->CursorClamp();
         render_selection &= state->HasSelection();
     }
 
     // Select the buffer to render.
-    const bool buf_display_from_state = (render_cursor || render_selection || g.ActiveId == id) && !is_readonly && state && state->TextAIsValid;
+    const bool buf_display_from_state = (render_cursor || render_selection || g.ActiveId == id) && !is_readonly && state;
     const bool is_displaying_hint = (hint != NULL && (buf_display_from_state ? state->TextA.Data : buf)[0] == 0);
 
     // Password pushes a temporary font with only a fallback glyph
@@ -3556,7 +4151,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         password_font->ContainerAtlas = g.Font->ContainerAtlas;
         password_font->FallbackGlyph = glyph;
         password_font->FallbackAdvanceX = glyph->AdvanceX;
-        IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
+        IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexPages.empty() && password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
         PushFont(password_font);
     }
 
@@ -3567,6 +4162,8 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         IM_ASSERT(state != NULL);
         backup_current_text_length = state->CurLenA;
         state->BufCapacityA = buf_size;
+        if (state->TextA.Size < buf_size + 1)
+            state->TextA.resize(buf_size + 1); // Callbacks are allowed to fill TextA up to BufCapacityA
         state->UserFlags = flags;
         state->UserCallback = callback;
         state->UserCallbackData = callback_user_data;
@@ -3617,7 +4214,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             {
                 unsigned int c = '\t'; // Insert TAB
                 if (InputTextFilterCharacter(&c, flags, callback, callback_user_data))
-                    state->OnKeyPressed((int)c);
+                    state->OnCharPressed(c);
             }
 
         // Process regular text input (before we check for Return because using some IME will effectively send a Return?)
@@ -3632,7 +4229,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                     if (c == '\t' && io.KeyShift)
                         continue;
                     if (InputTextFilterCharacter(&c, flags, callback, callback_user_data))
-                        state->OnKeyPressed((int)c);
+                        state->OnCharPressed(c);
                 }
 
             // Consume characters
@@ -3689,7 +4286,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             {
                 unsigned int c = '\n'; // Insert new line
                 if (InputTextFilterCharacter(&c, flags, callback, callback_user_data))
-                    state->OnKeyPressed((int)c);
+                    state->OnCharPressed(c);
             }
         }
         else if (IsKeyPressedMap(ImGuiKey_Escape))
@@ -3712,10 +4309,10 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             if (io.SetClipboardTextFn)
             {
                 const int ib = state->HasSelection() ? ImMin(state->Stb.select_start, state->Stb.select_end) : 0;
-                const int ie = state->HasSelection() ? ImMax(state->Stb.select_start, state->Stb.select_end) : state->CurLenW;
-                const int clipboard_data_len = ImTextCountUtf8BytesFromStr(state->TextW.Data + ib, state->TextW.Data + ie) + 1;
-                char* clipboard_data = (char*)IM_ALLOC(clipboard_data_len * sizeof(char));
-                ImTextStrToUtf8(clipboard_data, clipboard_data_len, state->TextW.Data + ib, state->TextW.Data + ie);
+                const int ie = state->HasSelection() ? ImMax(state->Stb.select_start, state->Stb.select_end) : state->CurLenA;
+                char* clipboard_data = (char*)IM_ALLOC((ie - ib + 1) * sizeof(char));
+                memcpy(clipboard_data, state->TextA.Data + ib, (size_t)(ie - ib));
+                clipboard_data[ie - ib] = 0;
                 SetClipboardText(clipboard_data);
                 MemFree(clipboard_data);
             }
@@ -3731,27 +4328,59 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         {
             if (const char* clipboard = GetClipboardText())
             {
-                // Filter pasted buffer
-                const int clipboard_len = (int)strlen(clipboard);
-                ImWchar* clipboard_filtered = (ImWchar*)IM_ALLOC((clipboard_len+1) * sizeof(ImWchar));
-                int clipboard_filtered_len = 0;
-                for (const char* s = clipboard; *s; )
+                // Filter pasted buffer (filters may replace characters, so we re-encode them)
+                // Characters passing the filters unchanged are only copied once a character gets dropped or altered, so we usually paste straight from the clipboard.
+                // Without character filters, runs of printable ASCII characters can't be altered so we skip them in bulk.
+                const char* clipboard_end = clipboard + strlen(clipboard);
+                const bool can_skip_ascii_runs = (flags & (ImGuiInputTextFlags_CharsDecimal | ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CharsUppercase | ImGuiInputTextFlags_CharsNoBlank | ImGuiInputTextFlags_CharsScientific | ImGuiInputTextFlags_CallbackCharFilter)) == 0;
+                ImVector<char> clipboard_filtered;
+                bool clipboard_altered = false;
+                const char* clipboard_unchanged_begin = clipboard; // Start of the characters which passed unchanged and were not copied yet
+                for (const char* s = clipboard; s < clipboard_end; )
                 {
+                    if (can_skip_ascii_runs && (s = ImTextFindNonAscii(s, clipboard_end, 0x20)) == clipboard_end)
+                        break;
+                    const char* c_begin = s;
                     unsigned int c;
-                    s += ImTextCharFromUtf8(&c, s, NULL);
+                    s += ImTextCharFromUtf8(&c, s, clipboard_end);
                     if (c == 0)
+                    {
+                        clipboard_end = c_begin;
                         break;
-                    if (c >= 0x10000 || !InputTextFilterCharacter(&c, flags, callback, callback_user_data))
-                        continue;
-                    clipboard_filtered[clipboard_filtered_len++] = (ImWchar)c;
+                    }
+                    char c_utf8[5];
+                    int c_utf8_len = 0;
+                    const unsigned int c_decoded = c;
+                    if (InputTextFilterCharacter(&c, flags, callback, callback_user_data))
+                    {
+                        // Valid UTF-8 sequences would be re-encoded to the same bytes
+                        if (c == c_decoded && c != IM_UNICODE_CODEPOINT_INVALID && c <= IM_UNICODE_CODEPOINT_MAX)
+                            continue;
+                        const ImWchar wc = (ImWchar)c;
+                        c_utf8_len = ImTextStrToUtf8(c_utf8, IM_ARRAYSIZE(c_utf8), &wc, &wc + 1);
+                        if (c_utf8_len == (int)(s - c_begin) && memcmp(c_utf8, c_begin, (size_t)c_utf8_len) == 0)
+                            continue;
+                    }
+                    if (!clipboard_altered)
+                        clipboard_filtered.reserve((int)(clipboard_end - clipboard) + 1);
+                    clipboard_altered = true;
+                    InputTextAppendChars(&clipboard_filtered, clipboard_unchanged_begin, c_begin);
+                    InputTextAppendChars(&clipboard_filtered, c_utf8, c_utf8 + c_utf8_len);
+                    clipboard_unchanged_begin = s;
+                }
+                const char* paste_text = clipboard;
+                int paste_text_len = (int)(clipboard_end - clipboard);
+                if (clipboard_altered)
+                {
+                    InputTextAppendChars(&clipboard_filtered, clipboard_unchanged_begin, clipboard_end);
+                    paste_text = clipboard_filtered.Data;
+                    paste_text_len = clipboard_filtered.Size;
                 }
-                clipboard_filtered[clipboard_filtered_len] = 0;
-                if (clipboard_filtered_len > 0) // If everything was filtered, ignore the pasting operation
+                if (paste_text_len > 0) // If everything was filtered, ignore the pasting operation
                 {
-                    stb_textedit_paste(state, &state->Stb, clipboard_filtered, clipboard_filtered_len);
+                    stb_textedit_paste(state, &state->Stb, paste_text, paste_text_len);
                     state->CursorFollow = true;
                 }
-                MemFree(clipboard_filtered);
             }
         }
 
@@ -3765,10 +4394,11 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         IM_ASSERT(state != NULL);
         const char* apply_new_text = NULL;
         int apply_new_text_length = 0;
+        int apply_new_text_offset = 0;      // First byte where the user buffer differs from the new text, so we only write the modified tail
         if (cancel_edit)
         {
             // Restore initial value. Only return true if restoring to the initial value changes the current buffer contents.
-            if (!is_readonly && strcmp(buf, state->InitialTextA.Data) != 0)
+            if (!is_readonly && (apply_new_text_offset = InputTextFindFirstDifference(state->InitialTextA.Data, state->InitialTextA.Size - 1, buf, buf_size)) != -1)
             {
                 apply_new_text = state->InitialTextA.Data;
                 apply_new_text_length = state->InitialTextA.Size - 1;
@@ -3783,13 +4413,6 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             // Apply new value immediately - copy modified buffer back
             // Note that as soon as the input box is active, the in-widget value gets priority over any underlying modification of the input buffer
             // FIXME: We actually always render 'buf' when calling DrawList->AddText, making the comment above incorrect.
-            // FIXME-OPT: CPU waste to do this every time the widget is active, should mark dirty state from the stb_textedit callbacks.
-            if (!is_readonly)
-            {
-                state->TextAIsValid = true;
-                state->TextA.resize(state->TextW.Size * 4 + 1);
-                ImTextStrToUtf8(state->TextA.Data, state->TextA.Size, state->TextW.Data, NULL);
-            }
 
             // User callback
             if ((flags & (ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackHistory | ImGuiInputTextFlags_CallbackAlways)) != 0)
@@ -3831,11 +4454,10 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                     callback_data.BufSize = state->BufCapacityA;
                     callback_data.BufDirty = false;
 
-                    // We have to convert from wchar-positions to UTF-8-positions, which can be pretty slow (an incentive to ditch the ImWchar buffer, see https://github.com/nothings/stb/issues/188)
-                    ImWchar* text = state->TextW.Data;
-                    const int utf8_cursor_pos = callback_data.CursorPos = ImTextCountUtf8BytesFromStr(text, text + state->Stb.cursor);
-                    const int utf8_selection_start = callback_data.SelectionStart = ImTextCountUtf8BytesFromStr(text, text + state->Stb.select_start);
-                    const int utf8_selection_end = callback_data.SelectionEnd = ImTextCountUtf8BytesFromStr(text, text + state->Stb.select_end);
+                    // Positions are UTF-8 byte offsets on both sides
+                    const int utf8_cursor_pos = callback_data.CursorPos = state->Stb.cursor;
+                    const int utf8_selection_start = callback_data.SelectionStart = state->Stb.select_start;
+                    const int utf8_selection_end = callback_data.SelectionEnd = state->Stb.select_end;
 
                     // Call user code
                     callback(&callback_data);
@@ -3844,23 +4466,25 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                     IM_ASSERT(callback_data.Buf == state->TextA.Data);  // Invalid to modify those fields
                     IM_ASSERT(callback_data.BufSize == state->BufCapacityA);
                     IM_ASSERT(callback_data.Flags == flags);
-                    if (callback_data.CursorPos != utf8_cursor_pos)            { state->Stb.cursor = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.CursorPos); state->CursorFollow = true; }
-                    if (callback_data.SelectionStart != utf8_selection_start)  { state->Stb.select_start = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.SelectionStart); }
-                    if (callback_data.SelectionEnd != utf8_selection_end)      { state->Stb.select_end = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.SelectionEnd); }
+                    if (callback_data.CursorPos != utf8_cursor_pos)            { state->Stb.cursor = callback_data.CursorPos; state->CursorFollow = true; }
+                    if (callback_data.SelectionStart != utf8_selection_start)  { state->Stb.select_start = callback_data.SelectionStart; }
+                    if (callback_data.SelectionEnd != utf8_selection_end)      { state->Stb.select_end = callback_data.SelectionEnd; }
                     if (callback_data.BufDirty)
                     {
                         IM_ASSERT(callback_data.BufTextLen == (int)strlen(callback_data.Buf)); // You need to maintain BufTextLen if you change the text!
-                        if (callback_data.BufTextLen > backup_current_text_length && is_resizable)
-                            state->TextW.resize(state->TextW.Size + (callback_data.BufTextLen - backup_current_text_length));
-                        state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, state->TextW.Size, callback_data.Buf, NULL);
                         state->CurLenA = callback_data.BufTextLen;  // Assume correct length and valid UTF-8 from user, saves us an extra strlen()
+                        state->OnTextReplaced();
                         state->CursorAnimReset();
+                        state->Stb.undostate.Clear(); // Undo records are byte offsets into the text we had before the callback
                     }
+
+                    // Positions are byte offsets: a callback counting in characters could land inside a UTF-8 sequence, which later edits would corrupt
+                    state->CursorClamp();
                 }
             }
 
             // Will copy result string if modified
-            if (!is_readonly && strcmp(state->TextA.Data, buf) != 0)
+            if (!is_readonly && (apply_new_text_offset = InputTextFindFirstDifference(state->TextA.Data, state->CurLenA, buf, buf_size)) != -1)
             {
                 apply_new_text = state->TextA.Data;
                 apply_new_text_length = state->CurLenA;
@@ -3881,6 +4505,8 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                 callback_data.BufSize = ImMax(buf_size, apply_new_text_length + 1);
                 callback_data.UserData = callback_user_data;
                 callback(&callback_data);
+                if (callback_data.Buf != buf)
+                    apply_new_text_offset = 0; // Don't assume the contents were carried over to the new buffer
                 buf = callback_data.Buf;
                 buf_size = callback_data.BufSize;
                 apply_new_text_length = ImMin(callback_data.BufTextLen, buf_size - 1);
@@ -3888,7 +4514,14 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             }
 
             // If the underlying buffer resize was denied or not carried to the next frame, apply_new_text_length+1 may be >= buf_size.
-            ImStrncpy(buf, apply_new_text, ImMin(apply_new_text_length + 1, buf_size));
+            // The bytes before apply_new_text_offset already match, so only the modified tail is written (e.g. typing at the end of a large text).
+            if (buf_size > 0)
+            {
+                const int copy_end = ImMin(apply_new_text_length, buf_size - 1);
+                if (apply_new_text_offset < copy_end)
+                    memcpy(buf + apply_new_text_offset, apply_new_text + apply_new_text_offset, (size_t)(copy_end - apply_new_text_offset));
+                buf[copy_end] = 0;
+            }
             value_changed = true;
         }
 
@@ -3938,54 +4571,31 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         // - Display the text (this alone can be more easily clipped)
         // - Handle scrolling, highlight selection, display cursor (those all requires some form of 1d->2d cursor position calculation)
         // - Measure text height (for scrollbar)
-        // We are attempting to do most of that in **one main pass** to minimize the computation cost (non-negligible for large amount of text) + 2nd pass for selection rendering (we could merge them by an extra refactoring effort)
-        // FIXME: This should occur on buf_display but we'd need to maintain cursor/select_start/select_end for UTF-8.
-        const ImWchar* text_begin = state->TextW.Data;
+        // We use the line index maintained by edits (ImGuiInputTextState::LineStarts) so that we only need to measure and render the visible lines,
+        // and the cost of a frame doesn't depend on the length of the text.
+        // FIXME: This should occur on buf_display but we'd need to maintain cursor/select_start/select_end for it.
+        const char* text_begin = state->TextA.Data;
         ImVec2 cursor_offset, select_start_offset;
+        state->UpdateLineIndex();
+        const int* lines = state->LineStarts.Data;
+        const int line_count = state->LineStarts.Size;
+        int select_start_line_no = 0;
 
         {
-            // Find lines numbers straddling 'cursor' (slot 0) and 'select_start' (slot 1) positions.
-            const ImWchar* searches_input_ptr[2] = { NULL, NULL };
-            int searches_result_line_no[2] = { -1000, -1000 };
-            int searches_remaining = 0;
+            // Find lines numbers of 'cursor' and 'select_start' positions
+            // Calculate 2d position by measuring distance from the beginning of the line
             if (render_cursor)
             {
-                searches_input_ptr[0] = text_begin + state->Stb.cursor;
-                searches_result_line_no[0] = -1;
-                searches_remaining++;
+                const int line_no = state->FindLineNo(state->Stb.cursor);
+                cursor_offset.x = InputTextCalcTextSize(text_begin + lines[line_no], text_begin + state->Stb.cursor).x;
+                cursor_offset.y = (line_no + 1) * g.FontSize;
             }
             if (render_selection)
             {
-                searches_input_ptr[1] = text_begin + ImMin(state->Stb.select_start, state->Stb.select_end);
-                searches_result_line_no[1] = -1;
-                searches_remaining++;
-            }
-
-            // Iterate all lines to find our line numbers
-            // In multi-line mode, we never exit the loop until all lines are counted, so add one extra to the searches_remaining counter.
-            searches_remaining += is_multiline ? 1 : 0;
-            int line_count = 0;
-            //for (const ImWchar* s = text_begin; (s = (const ImWchar*)wcschr((const wchar_t*)s, (wchar_t)'\n')) != NULL; s++)  // FIXME-OPT: Could use this when wchar_t are 16-bits
-            for (const ImWchar* s = text_begin; *s != 0; s++)
-                if (*s == '\n')
-                {
-                    line_count++;
-                    if (searches_result_line_no[0] == -1 && s >= searches_input_ptr[0]) { searches_result_line_no[0] = line_count; if (--searches_remaining <= 0) break; }
-                    if (searches_result_line_no[1] == -1 && s >= searches_input_ptr[1]) { searches_result_line_no[1] = line_count; if (--searches_remaining <= 0) break; }
-                }
-            line_count++;
-            if (searches_result_line_no[0] == -1)
-                searches_result_line_no[0] = line_count;
-            if (searches_result_line_no[1] == -1)
-                searches_result_line_no[1] = line_count;
-
-            // Calculate 2d position by finding the beginning of the line and measuring distance
-            cursor_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[0], text_begin), searches_input_ptr[0]).x;
-            cursor_offset.y = searches_result_line_no[0] * g.FontSize;
-            if (searches_result_line_no[1] >= 0)
-            {
-                select_start_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[1], text_begin), searches_input_ptr[1]).x;
-                select_start_offset.y = searches_result_line_no[1] * g.FontSize;
+                const int select_start = ImMin(state->Stb.select_start, state->Stb.select_end);
+                select_start_line_no = state->FindLineNo(select_start);
+                select_start_offset.x = InputTextCalcTextSize(text_begin + lines[select_start_line_no], text_begin + select_start).x;
+                select_start_offset.y = (select_start_line_no + 1) * g.FontSize;
             }
 
             // Store text height (note that we haven't calculated text width at all, see GitHub issues #383, #1224)
@@ -4025,45 +4635,51 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             state->CursorFollow = false;
         }
 
+        // Find visible lines
+        int visible_line_min = 0, visible_line_max = line_count - 1;
+        if (is_multiline)
+        {
+            visible_line_min = ImClamp((int)ImFloor((clip_rect.y - draw_pos.y) / g.FontSize), 0, line_count - 1);
+            visible_line_max = ImClamp((int)ImFloor((clip_rect.w - draw_pos.y) / g.FontSize), visible_line_min, line_count - 1);
+        }
+
         // Draw selection
         const ImVec2 draw_scroll = ImVec2(state->ScrollX, 0.0f);
         if (render_selection)
         {
-            const ImWchar* text_selected_begin = text_begin + ImMin(state->Stb.select_start, state->Stb.select_end);
-            const ImWchar* text_selected_end = text_begin + ImMax(state->Stb.select_start, state->Stb.select_end);
+            const int text_selected_begin = ImMin(state->Stb.select_start, state->Stb.select_end);
+            const int text_selected_end = ImMax(state->Stb.select_start, state->Stb.select_end);
+            int select_end_line_no = state->FindLineNo(text_selected_end);
+            if (select_end_line_no > select_start_line_no && lines[select_end_line_no] == text_selected_end)
+                select_end_line_no--; // Selection ends right after a \n
 
             ImU32 bg_color = GetColorU32(ImGuiCol_TextSelectedBg, render_cursor ? 1.0f : 0.6f); // FIXME: current code flow mandate that render_cursor is always true here, we are leaving the transparent one for tests.
             float bg_offy_up = is_multiline ? 0.0f : -1.0f;    // FIXME: those offsets should be part of the style? they don't play so well with multi-line selection.
             float bg_offy_dn = is_multiline ? 0.0f : 2.0f;
-            ImVec2 rect_pos = draw_pos + select_start_offset - draw_scroll;
-            for (const ImWchar* p = text_selected_begin; p < text_selected_end; )
+            for (int line_no = ImMax(select_start_line_no, visible_line_min); line_no <= ImMin(select_end_line_no, visible_line_max) && text_selected_begin < text_selected_end; line_no++)
             {
-                if (rect_pos.y > clip_rect.w + g.FontSize)
-                    break;
-                if (rect_pos.y < clip_rect.y)
-                {
-                    //p = (const ImWchar*)wmemchr((const wchar_t*)p, '\n', text_selected_end - p);  // FIXME-OPT: Could use this when wchar_t are 16-bits
-                    //p = p ? p + 1 : text_selected_end;
-                    while (p < text_selected_end)
-                        if (*p++ == '\n')
-                            break;
-                }
-                else
-                {
-                    ImVec2 rect_size = InputTextCalcTextSizeW(p, text_selected_end, &p, NULL, true);
-                    if (rect_size.x <= 0.0f) rect_size.x = (float)(int)(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see selected empty lines
-                    ImRect rect(rect_pos + ImVec2(0.0f, bg_offy_up - g.FontSize), rect_pos +ImVec2(rect_size.x, bg_offy_dn));
-                    rect.ClipWith(clip_rect);
-                    if (rect.Overlaps(clip_rect))
-                        draw_window->DrawList->AddRectFilled(rect.Min, rect.Max, bg_color);
-                }
-                rect_pos.x = draw_pos.x - draw_scroll.x;
-                rect_pos.y += g.FontSize;
+                const int p = (line_no == select_start_line_no) ? text_selected_begin : lines[line_no];
+                const int line_end = (line_no + 1 < line_count) ? lines[line_no + 1] - 1 : state->CurLenA; // Excluding \n
+                ImVec2 rect_pos = draw_pos - draw_scroll + ImVec2((line_no == select_start_line_no) ? select_start_offset.x : 0.0f, (line_no + 1) * g.FontSize);
+                ImVec2 rect_size = InputTextCalcTextSize(text_begin + p, text_begin + ImMin(text_selected_end, line_end));
+                if (rect_size.x <= 0.0f) rect_size.x = (float)(int)(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see selected empty lines
+                ImRect rect(rect_pos + ImVec2(0.0f, bg_offy_up - g.FontSize), rect_pos +ImVec2(rect_size.x, bg_offy_dn));
+                rect.ClipWith(clip_rect);
+                if (rect.Overlaps(clip_rect))
+                    draw_window->DrawList->AddRectFilled(rect.Min, rect.Max, bg_color);
             }
         }
 
         // We test for 'buf_display_max_length' as a way to avoid some pathological cases (e.g. single-line 1 MB string) which would make ImDrawList crash.
-        if (is_multiline || (buf_display_end - buf_display) < buf_display_max_length)
+        // In multi-line mode we only submit visible lines.
+        if (is_multiline && !is_displaying_hint)
+        {
+            const char* buf_display_visible_begin = buf_display + lines[visible_line_min];
+            const char* buf_display_visible_end = (visible_line_max + 1 < line_count) ? buf_display + lines[visible_line_max + 1] : buf_display_end;
+            ImVec2 visible_draw_pos = draw_pos - draw_scroll + ImVec2(0.0f, visible_line_min * g.FontSize);
+            draw_window->DrawList->AddText(g.Font, g.FontSize, visible_draw_pos, GetColorU32(ImGuiCol_Text), buf_display_visible_begin, buf_display_visible_end);
+        }
+        else if (is_multiline || (buf_display_end - buf_display) < buf_display_max_length)
         {
             ImU32 col = GetColorU32(is_displaying_hint ? ImGuiCol_TextDisabled : ImGuiCol_Text);
             draw_window->DrawList->AddText(g.Font, g.FontSize, draw_pos - draw_scroll, col, buf_display, buf_display_end, 0.0f, is_multiline ? NULL : &clip_rect);
@@ -4128,6 +4744,268 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         return value_changed;
 }
 
+//-------------------------------------------------------------------------
+// [SECTION] Widgets: ImGuiTextView
+//-------------------------------------------------------------------------
+// - ImGuiTextView::SetText()
+// - ImGuiTextView::SetSearch()
+// - ImGuiTextView::Draw()
+// - ImGuiTextView::CopySelectionToClipboard()
+//-------------------------------------------------------------------------
+
+// Searching a huge text for a new search string is spread over several frames
+static const int TEXTVIEW_SEARCH_BYTES_PER_FRAME = 16 * 1024 * 1024;
+
+ImGuiTextView::ImGuiTextView()
+{
+    Text = NULL;
+    TextSize = 0;
+    SelectionStart = SelectionEnd = 0;
+    AutoScroll = true;
+    SearchedSize = 0;
+}
+
+void ImGuiTextView::Clear()
+{
+    Text = NULL;
+    TextSize = 0;
+    SelectionStart = SelectionEnd = 0;
+    LineOffsets.clear();
+    SearchMatches.clear();
+    SearchedSize = 0;
+}
+
+void ImGuiTextView::SetText(const char* text, const char* text_end)
+{
+    const int text_size = (int)(text_end - text);
+    if (text_size < TextSize)
+        Clear(); // Text was truncated or replaced
+
+    // Index new lines
+    const int indexed_size = TextSize;
+    Text = text;
+    TextSize = text_size;
+    if (LineOffsets.Size == 0)
+        LineOffsets.push_back(0);
+    if (indexed_size < text_size)
+        for (const char* p = text + indexed_size; (p = (const char*)memchr(p, '\n', (size_t)(text_end - p))) != NULL; p++)
+            LineOffsets.push_back((int)(p + 1 - text));
+
+    // Search new bytes. A match may straddle the previously searched bytes.
+    const int search_len = Search.Size - 1;
+    if (search_len <= 0 || SearchedSize >= text_size)
+    {
+        SearchedSize = ImMax(SearchedSize, text_size);
+        return;
+    }
+    int search_start = ImMax(0, SearchedSize - (search_len - 1));
+    if (SearchMatches.Size > 0)
+        search_start = ImMax(search_start, SearchMatches.back() + search_len);
+    const int search_end = ImMin(text_size, SearchedSize + TEXTVIEW_SEARCH_BYTES_PER_FRAME);
+    const char* p = text + search_start;
+    const char* p_last = text + search_end - search_len; // Last possible start of a match
+    while (p <= p_last && (p = (const char*)memchr(p, Search[0], (size_t)(p_last - p + 1))) != NULL)
+    {
+        if (memcmp(p, Search.Data, (size_t)search_len) == 0)
+        {
+            SearchMatches.push_back((int)(p - text));
+            p += search_len;
+        }
+        else
+        {
+            p++;
+        }
+    }
+    SearchedSize = search_end;
+}
+
+void ImGuiTextView::SetSearch(const char* search)
+{
+    if (search == NULL)
+        search = "";
+    const int search_len = (int)strlen(search);
+    if (Search.Size == search_len + 1 && memcmp(Search.Data, search, (size_t)search_len) == 0)
+        return;
+    Search.resize(search_len + 1);
+    memcpy(Search.Data, search, (size_t)search_len + 1);
+    SearchMatches.resize(0);
+    SearchedSize = 0; // Searched again on the next SetText() call
+}
+
+void ImGuiTextView::CopySelectionToClipboard() const
+{
+    const int sel_min = ImClamp(ImMin(SelectionStart, SelectionEnd), 0, TextSize);
+    const int sel_max = ImClamp(ImMax(SelectionStart, SelectionEnd), 0, TextSize);
+    ImVector<char> clipboard_data;
+    clipboard_data.resize(sel_max - sel_min + 1);
+    memcpy(clipboard_data.Data, Text + sel_min, (size_t)(sel_max - sel_min));
+    clipboard_data[sel_max - sel_min] = 0;
+    ImGui::SetClipboardText(clipboard_data.Data);
+}
+
+static bool TextViewIsWordChar(char c)
+{
+    return (c & 0x80) || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+// Return the offset of the character boundary nearest to 'pos'
+static int TextViewGetOffsetFromPos(const ImGuiTextView* view, const ImVec2& text_pos, float line_height, const ImVec2& pos)
+{
+    ImGuiContext& g = *GImGui;
+    const int line_n = ImClamp((int)ImFloor((pos.y - text_pos.y) / line_height), 0, view->LineOffsets.Size - 1);
+    const char* line_begin = view->Text + view->LineOffsets[line_n];
+    const char* line_end = (line_n + 1 < view->LineOffsets.Size) ? view->Text + view->LineOffsets[line_n + 1] - 1 : view->Text + view->TextSize;
+    const float x = pos.x - text_pos.x;
+    if (x <= 0.0f)
+        return (int)(line_begin - view->Text);
+    const char* p = line_end;
+    const float width_before = g.Font->CalcTextSizeA(g.FontSize, x, 0.0f, line_begin, line_end, &p).x;
+    if (p < line_end)
+    {
+        unsigned int c;
+        const char* p_next = p + ImTextCharFromUtf8(&c, p, line_end);
+        if (x > width_before + g.Font->CalcTextSizeA(g.FontSize, FLT_MAX, 0.0f, p, p_next).x * 0.5f)
+            p = p_next;
+    }
+    return (int)(p - view->Text);
+}
+
+static void TextViewRenderRange(ImDrawList* draw_list, const ImVec2& line_pos, float line_height, const char* line_begin, const char* range_begin, const char* range_end, bool include_newline, ImU32 col)
+{
+    ImGuiContext& g = *GImGui;
+    const float x0 = (range_begin > line_begin) ? ImGui::CalcTextSize(line_begin, range_begin).x : 0.0f;
+    float x1 = (range_end > range_begin) ? x0 + ImGui::CalcTextSize(range_begin, range_end).x : x0;
+    if (include_newline)
+        x1 += (float)(int)(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see selected empty lines
+    if (x1 > x0)
+        draw_list->AddRectFilled(ImVec2(line_pos.x + x0, line_pos.y), ImVec2(line_pos.x + x1, line_pos.y + line_height), col);
+}
+
+void ImGuiTextView::Draw(const char* str_id, const ImVec2& size)
+{
+    using namespace ImGui;
+    ImGuiContext& g = *GImGui;
+    ImGuiIO& io = g.IO;
+    if (!BeginChild(str_id, size, false, ImGuiWindowFlags_HorizontalScrollbar))
+    {
+        EndChild();
+        return;
+    }
+
+    ImGuiWindow* window = g.CurrentWindow;
+    const ImGuiID id = window->GetID("#TEXTVIEW");
+    const float line_height = GetTextLineHeight();
+    const ImVec2 text_pos = window->DC.CursorPos;
+    const bool has_text = (LineOffsets.Size > 0);
+    SelectionStart = ImClamp(SelectionStart, 0, TextSize);
+    SelectionEnd = ImClamp(SelectionEnd, 0, TextSize);
+
+    // Mouse selection
+    const bool hovered = IsWindowHovered() && window->InnerClipRect.Contains(io.MousePos);
+    if (hovered)
+        g.MouseCursor = ImGuiMouseCursor_TextInput;
+    if (hovered && io.MouseClicked[0] && has_text)
+    {
+        SetActiveID(id, window);
+        const int offset = TextViewGetOffsetFromPos(this, text_pos, line_height, io.MousePos);
+        if (io.MouseDoubleClicked[0])
+        {
+            SelectionStart = SelectionEnd = offset;
+            while (SelectionStart > 0 && TextViewIsWordChar(Text[SelectionStart - 1]))
+                SelectionStart--;
+            while (SelectionEnd < TextSize && TextViewIsWordChar(Text[SelectionEnd]))
+                SelectionEnd++;
+        }
+        else
+        {
+            if (!io.KeyShift)
+                SelectionStart = offset;
+            SelectionEnd = offset;
+        }
+    }
+    else if (g.ActiveId == id)
+    {
+        if (io.MouseDown[0] && has_text && !io.MouseDoubleClicked[0] && io.MouseDownDuration[0] > 0.0f)
+        {
+            SelectionEnd = TextViewGetOffsetFromPos(this, text_pos, line_height, io.MousePos);
+            if (io.MousePos.y < window->InnerClipRect.Min.y)
+                SetScrollY(ImMax(window->Scroll.y - line_height, 0.0f));
+            else if (io.MousePos.y > window->InnerClipRect.Max.y)
+                SetScrollY(ImMin(window->Scroll.y + line_height, GetScrollMaxY()));
+        }
+        else if (!io.MouseDown[0])
+        {
+            ClearActiveID();
+        }
+    }
+
+    // Keyboard shortcuts
+    const bool is_shortcut_key = (io.ConfigMacOSXBehaviors ? (io.KeySuper && !io.KeyCtrl) : (io.KeyCtrl && !io.KeySuper)) && !io.KeyAlt && !io.KeyShift;
+    if (is_shortcut_key && IsWindowFocused())
+    {
+        if (IsKeyPressedMap(ImGuiKey_A))
+        {
+            SelectionStart = 0;
+            SelectionEnd = TextSize;
+        }
+        if (IsKeyPressedMap(ImGuiKey_C) && HasSelection())
+            CopySelectionToClipboard();
+    }
+
+    // Render visible lines, with search matches and selection behind the text
+    PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(g.Style.ItemSpacing.x, 0.0f));
+    const int sel_min = ImMin(SelectionStart, SelectionEnd);
+    const int sel_max = ImMax(SelectionStart, SelectionEnd);
+    const int search_len = Search.Size - 1;
+    const ImU32 sel_col = GetColorU32(ImGuiCol_TextSelectedBg);
+    const ImU32 match_col = GetColorU32(ImGuiCol_PlotHistogram, 0.40f);
+    ImGuiListClipper clipper(LineOffsets.Size, line_height);
+    while (clipper.Step())
+    {
+        int match_n = 0;
+        if (SearchMatches.Size > 0 && clipper.DisplayStart < clipper.DisplayEnd)
+        {
+            // Binary search the first match of the visible lines
+            const int line_start_offset = LineOffsets[clipper.DisplayStart];
+            int count = SearchMatches.Size;
+            while (count > 0)
+            {
+                const int half = count >> 1;
+                if (SearchMatches[match_n + half] + search_len <= line_start_offset) { match_n += half + 1; count -= half + 1; }
+                else { count = half; }
+            }
+        }
+        for (int line_n = clipper.DisplayStart; line_n < clipper.DisplayEnd; line_n++)
+        {
+            const int line_begin_offset = LineOffsets[line_n];
+            const int line_end_offset = (line_n + 1 < LineOffsets.Size) ? LineOffsets[line_n + 1] - 1 : TextSize;
+            const char* line_begin = Text + line_begin_offset;
+            const char* line_end = Text + line_end_offset;
+            const ImVec2 line_pos = window->DC.CursorPos;
+            for (; match_n < SearchMatches.Size && SearchMatches[match_n] <= line_end_offset; match_n++)
+            {
+                const char* match_begin = ImMax(Text + SearchMatches[match_n], line_begin);
+                const char* match_end = ImMin(Text + SearchMatches[match_n] + search_len, line_end);
+                TextViewRenderRange(window->DrawList, line_pos, line_height, line_begin, match_begin, match_end, false, match_col);
+                if (SearchMatches[match_n] + search_len > line_end_offset + 1)
+                    break; // Match continues on next line
+            }
+            if (sel_min < sel_max && sel_min <= line_end_offset && sel_max >= line_begin_offset)
+            {
+                const char* range_begin = Text + ImMax(sel_min, line_begin_offset);
+                const char* range_end = Text + ImMin(sel_max, line_end_offset);
+                TextViewRenderRange(window->DrawList, line_pos, line_height, line_begin, range_begin, range_end, sel_max > line_end_offset, sel_col);
+            }
+            TextUnformatted(line_begin, line_end);
+        }
+    }
+    PopStyleVar();
+
+    if (AutoScroll && g.ActiveId != id && GetScrollY() >= GetScrollMaxY())
+        SetScrollHereY(1.0f);
+    EndChild();
+}
+
 //-------------------------------------------------------------------------
 // [SECTION] Widgets: ColorEdit, ColorPicker, ColorButton, etc.
 //-------------------------------------------------------------------------
@@ -6332,6 +7210,7 @@ ImGuiTabBar::ImGuiTabBar()
     ID = 0;
     SelectedTabId = NextSelectedTabId = VisibleTabId = 0;
     CurrFrameVisible = PrevFrameVisible = -1;
+    Window = NULL;
     LastTabContentHeight = 0.0f;
     OffsetMax = OffsetMaxIdeal = OffsetNextTab = 0.0f;
     ScrollingAnim = ScrollingTarget = ScrollingTargetDistToVisibility = ScrollingSpeed = 0.0f;
@@ -6412,6 +7291,7 @@ bool    ImGui::BeginTabBarEx(ImGuiTabBar* tab_bar, const ImRect& tab_bar_bb, ImG
     tab_bar->WantLayout = true; // Layout will be done on the first call to ItemTab()
     tab_bar->PrevFrameVisible = tab_bar->CurrFrameVisible;
     tab_bar->CurrFrameVisible = g.FrameCount;
+    tab_bar->Window = window;
     tab_bar->FramePadding = g.Style.FramePadding;
 
     // Layout
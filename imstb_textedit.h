@@ -2,6 +2,10 @@
 // This is a slightly modified version of stb_textedit.h 1.13. 
 // Those changes would need to be pushed into nothings/stb:
 // - Fix in stb_textedit_discard_redo (see https://github.com/nothings/stb/issues/321)
+// - Optional STB_TEXTEDIT_FIND_ROW_FROM_CHAR/STB_TEXTEDIT_FIND_ROW_FROM_Y to locate rows without laying out all preceding rows
+// - Optional STB_TEXTEDIT_GETNEXTCHARINDEX/STB_TEXTEDIT_GETPREVCHARINDEX to edit variable-length encodings (e.g. UTF-8)
+// - Added stb_textedit_text() to insert multiple STB_TEXTEDIT_CHARTYPE making up a single character
+// - Optional STB_TEXTEDIT_UNDOSTATE to replace the fixed-size undo buffers with your own undo system
 // Grep for [DEAR IMGUI] to find the changes.
 
 // stb_textedit.h - v1.13  - public domain - Sean Barrett
@@ -96,6 +100,12 @@
 //        [4 + 3 * sizeof(STB_TEXTEDIT_POSITIONTYPE)] * STB_TEXTEDIT_UNDOSTATE_COUNT
 //      +          sizeof(STB_TEXTEDIT_CHARTYPE)      * STB_TEXTEDIT_UNDOCHAR_COUNT
 //
+//   [DEAR IMGUI] Alternatively you can define STB_TEXTEDIT_UNDOSTATE to your own type, which
+//   is stored in STB_TexteditState instead of the built-in buffers. The built-in undo functions
+//   are then compiled out and you must implement stb_text_undo(), stb_text_redo(),
+//   stb_text_makeundo_insert(), stb_text_makeundo_delete(), stb_text_makeundo_replace() and
+//   stb_text_clearundo() (see their forward declarations) after including the implementation.
+//
 //
 // Implementation mode:
 //
@@ -169,6 +179,15 @@
 //    STB_TEXTEDIT_K_LINEEND2            secondary keyboard input to move cursor to end of line
 //    STB_TEXTEDIT_K_TEXTSTART2          secondary keyboard input to move cursor to start of text
 //    STB_TEXTEDIT_K_TEXTEND2            secondary keyboard input to move cursor to end of text
+//    STB_TEXTEDIT_FIND_ROW_FROM_CHAR(obj,n,&prev,&y)  [DEAR IMGUI] returns the first character of the row containing
+//                                          character #n (or of the last row if n is the string length), and
+//                                          writes the first character of the previous row and the row's y offset
+//    STB_TEXTEDIT_FIND_ROW_FROM_Y(obj,y,&base_y)      [DEAR IMGUI] returns the first character of the row straddling
+//                                          'y' (clamped to the first/last row), and writes the row's y offset
+//    STB_TEXTEDIT_GETNEXTCHARINDEX(obj,i)  [DEAR IMGUI] returns the index of the character following the one at
+//                                          index i, when characters can span multiple STB_TEXTEDIT_CHARTYPE
+//                                          (e.g. UTF-8). Indices are always in STB_TEXTEDIT_CHARTYPE units.
+//    STB_TEXTEDIT_GETPREVCHARINDEX(obj,i)  [DEAR IMGUI] returns the index of the character preceding index i
 //
 // Todo:
 //    STB_TEXTEDIT_K_PGUP        keyboard input to move cursor up a page
@@ -207,6 +226,7 @@
 //    int  stb_textedit_cut(STB_TEXTEDIT_STRING *str, STB_TexteditState *state)
 //    int  stb_textedit_paste(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, STB_TEXTEDIT_CHARTYPE *text, int len)
 //    void stb_textedit_key(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, STB_TEXEDIT_KEYTYPE key)
+//    void stb_textedit_text(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, STB_TEXTEDIT_CHARTYPE const *text, int text_len)   [DEAR IMGUI]
 //
 //    Each of these functions potentially updates the string and updates the
 //    state.
@@ -307,6 +327,9 @@ typedef struct
    int                        char_storage;
 } StbUndoRecord;
 
+#ifdef STB_TEXTEDIT_UNDOSTATE // [DEAR IMGUI] user-provided undo system
+typedef STB_TEXTEDIT_UNDOSTATE StbUndoState;
+#else
 typedef struct
 {
    // private data
@@ -315,6 +338,7 @@ typedef struct
    short undo_point, redo_point;
    int undo_char_point, redo_char_point;
 } StbUndoState;
+#endif
 
 typedef struct
 {
@@ -386,6 +410,14 @@ typedef struct
 #define STB_TEXTEDIT_memmove memmove
 #endif
 
+// [DEAR IMGUI] variable-length characters
+#ifndef STB_TEXTEDIT_GETNEXTCHARINDEX
+#define STB_TEXTEDIT_GETNEXTCHARINDEX(obj, idx) ((idx) + 1)
+#endif
+#ifndef STB_TEXTEDIT_GETPREVCHARINDEX
+#define STB_TEXTEDIT_GETPREVCHARINDEX(obj, idx) ((idx) - 1)
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////
 //
@@ -404,6 +436,11 @@ static int stb_text_locate_coord(STB_TEXTEDIT_STRING *str, float x, float y)
    r.ymin = r.ymax = 0;
    r.num_chars = 0;
 
+   // [DEAR IMGUI] skip directly to the row straddling 'y'
+#ifdef STB_TEXTEDIT_FIND_ROW_FROM_Y
+   i = STB_TEXTEDIT_FIND_ROW_FROM_Y(str, y, &base_y);
+#endif
+
    // search rows to find one that straddles 'y'
    while (i < n) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -432,13 +469,13 @@ static int stb_text_locate_coord(STB_TEXTEDIT_STRING *str, float x, float y)
    if (x < r.x1) {
       // search characters in row for one that straddles 'x'
       prev_x = r.x0;
-      for (k=0; k < r.num_chars; ++k) {
+      for (k=0; k < r.num_chars; k = STB_TEXTEDIT_GETNEXTCHARINDEX(str, i + k) - i) { // [DEAR IMGUI]
          float w = STB_TEXTEDIT_GETWIDTH(str, i, k);
          if (x < prev_x+w) {
             if (x < prev_x+w/2)
                return k+i;
             else
-               return k+i+1;
+               return STB_TEXTEDIT_GETNEXTCHARINDEX(str, i + k);
          }
          prev_x += w;
       }
@@ -502,6 +539,9 @@ static void stb_text_redo(STB_TEXTEDIT_STRING *str, STB_TexteditState *state);
 static void stb_text_makeundo_delete(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length);
 static void stb_text_makeundo_insert(STB_TexteditState *state, int where, int length);
 static void stb_text_makeundo_replace(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int old_length, int new_length);
+#ifdef STB_TEXTEDIT_UNDOSTATE
+static void stb_text_clearundo(STB_TexteditState *state); // [DEAR IMGUI]
+#endif
 
 typedef struct
 {
@@ -534,6 +574,13 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
          find->y = 0;
          find->x = 0;
          find->height = 1;
+         // [DEAR IMGUI] skip directly to the last row
+#ifdef STB_TEXTEDIT_FIND_ROW_FROM_CHAR
+         {
+            float row_y;
+            i = STB_TEXTEDIT_FIND_ROW_FROM_CHAR(str, z, &prev_start, &row_y);
+         }
+#endif
          while (i < z) {
             STB_TEXTEDIT_LAYOUTROW(&r, str, i);
             prev_start = i;
@@ -549,6 +596,11 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
    // search rows to find the one that straddles character n
    find->y = 0;
 
+   // [DEAR IMGUI] skip directly to the row containing character n
+#ifdef STB_TEXTEDIT_FIND_ROW_FROM_CHAR
+   i = STB_TEXTEDIT_FIND_ROW_FROM_CHAR(str, n, &prev_start, &find->y);
+#endif
+
    for(;;) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
       if (n < i + r.num_chars)
@@ -565,7 +617,7 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
 
    // now scan to find xpos
    find->x = r.x0;
-   for (i=0; first+i < n; ++i)
+   for (i=0; first+i < n; i = STB_TEXTEDIT_GETNEXTCHARINDEX(str, first + i) - first) // [DEAR IMGUI]
       find->x += STB_TEXTEDIT_GETWIDTH(str, first, i);
 }
 
@@ -714,9 +766,11 @@ static int stb_textedit_paste_internal(STB_TEXTEDIT_STRING *str, STB_TexteditSta
       state->has_preferred_x = 0;
       return 1;
    }
+#ifndef STB_TEXTEDIT_UNDOSTATE // [DEAR IMGUI] a user-provided undo system keeps the record of the deleted selection
    // remove the undo since we didn't actually insert the characters
    if (state->undostate.undo_point)
       --state->undostate.undo_point;
+#endif
    return 0;
 }
 
@@ -724,6 +778,31 @@ static int stb_textedit_paste_internal(STB_TEXTEDIT_STRING *str, STB_TexteditSta
 #define STB_TEXTEDIT_KEYTYPE int
 #endif
 
+// [DEAR IMGUI] API text: insert a character which may be made of multiple STB_TEXTEDIT_CHARTYPE, as typed by the user
+static void stb_textedit_text(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, STB_TEXTEDIT_CHARTYPE const *text, int text_len)
+{
+   // can't add newline in single-line mode
+   if (text[0] == '\n' && state->single_line)
+      return;
+
+   if (state->insert_mode && !STB_TEXT_HAS_SELECTION(state) && state->cursor < STB_TEXTEDIT_STRINGLEN(str)) {
+      int overwritten_len = STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor) - state->cursor;
+      stb_text_makeundo_replace(str, state, state->cursor, overwritten_len, text_len);
+      STB_TEXTEDIT_DELETECHARS(str, state->cursor, overwritten_len);
+      if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, text_len)) {
+         state->cursor += text_len;
+         state->has_preferred_x = 0;
+      }
+   } else {
+      stb_textedit_delete_selection(str,state); // implicitly clamps
+      if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, text_len)) {
+         stb_text_makeundo_insert(state, state->cursor, text_len);
+         state->cursor += text_len;
+         state->has_preferred_x = 0;
+      }
+   }
+}
+
 // API key: process a keyboard input
 static void stb_textedit_key(STB_TEXTEDIT_STRING *str, STB_TexteditState *state, STB_TEXTEDIT_KEYTYPE key)
 {
@@ -733,26 +812,7 @@ retry:
          int c = STB_TEXTEDIT_KEYTOTEXT(key);
          if (c > 0) {
             STB_TEXTEDIT_CHARTYPE ch = (STB_TEXTEDIT_CHARTYPE) c;
-
-            // can't add newline in single-line mode
-            if (c == '\n' && state->single_line)
-               break;
-
-            if (state->insert_mode && !STB_TEXT_HAS_SELECTION(state) && state->cursor < STB_TEXTEDIT_STRINGLEN(str)) {
-               stb_text_makeundo_replace(str, state, state->cursor, 1, 1);
-               STB_TEXTEDIT_DELETECHARS(str, state->cursor, 1);
-               if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, &ch, 1)) {
-                  ++state->cursor;
-                  state->has_preferred_x = 0;
-               }
-            } else {
-               stb_textedit_delete_selection(str,state); // implicitly clamps
-               if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, &ch, 1)) {
-                  stb_text_makeundo_insert(state, state->cursor, 1);
-                  ++state->cursor;
-                  state->has_preferred_x = 0;
-               }
-            }
+            stb_textedit_text(str, state, &ch, 1); // [DEAR IMGUI]
          }
          break;
       }
@@ -779,7 +839,7 @@ retry:
             stb_textedit_move_to_first(state);
          else 
             if (state->cursor > 0)
-               --state->cursor;
+               state->cursor = STB_TEXTEDIT_GETPREVCHARINDEX(str, state->cursor); // [DEAR IMGUI]
          state->has_preferred_x = 0;
          break;
 
@@ -788,7 +848,7 @@ retry:
          if (STB_TEXT_HAS_SELECTION(state))
             stb_textedit_move_to_last(str, state);
          else
-            ++state->cursor;
+            state->cursor = STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor); // [DEAR IMGUI]
          stb_textedit_clamp(str, state);
          state->has_preferred_x = 0;
          break;
@@ -798,7 +858,7 @@ retry:
          stb_textedit_prep_selection_at_cursor(state);
          // move selection left
          if (state->select_end > 0)
-            --state->select_end;
+            state->select_end = STB_TEXTEDIT_GETPREVCHARINDEX(str, state->select_end); // [DEAR IMGUI]
          state->cursor = state->select_end;
          state->has_preferred_x = 0;
          break;
@@ -848,7 +908,7 @@ retry:
       case STB_TEXTEDIT_K_RIGHT | STB_TEXTEDIT_K_SHIFT:
          stb_textedit_prep_selection_at_cursor(state);
          // move selection right
-         ++state->select_end;
+         state->select_end = STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->select_end); // [DEAR IMGUI]
          stb_textedit_clamp(str, state);
          state->cursor = state->select_end;
          state->has_preferred_x = 0;
@@ -883,7 +943,7 @@ retry:
             state->cursor = start;
             STB_TEXTEDIT_LAYOUTROW(&row, str, state->cursor);
             x = row.x0;
-            for (i=0; i < row.num_chars; ++i) {
+            for (i=0; i < row.num_chars; i = state->cursor - start) { // [DEAR IMGUI]
                float dx = STB_TEXTEDIT_GETWIDTH(str, start, i);
                #ifdef STB_TEXTEDIT_GETWIDTH_NEWLINE
                if (dx == STB_TEXTEDIT_GETWIDTH_NEWLINE)
@@ -892,7 +952,7 @@ retry:
                x += dx;
                if (x > goal_x)
                   break;
-               ++state->cursor;
+               state->cursor = STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
             }
             stb_textedit_clamp(str, state);
 
@@ -934,7 +994,7 @@ retry:
             state->cursor = find.prev_first;
             STB_TEXTEDIT_LAYOUTROW(&row, str, state->cursor);
             x = row.x0;
-            for (i=0; i < row.num_chars; ++i) {
+            for (i=0; i < row.num_chars; i = state->cursor - find.prev_first) { // [DEAR IMGUI]
                float dx = STB_TEXTEDIT_GETWIDTH(str, find.prev_first, i);
                #ifdef STB_TEXTEDIT_GETWIDTH_NEWLINE
                if (dx == STB_TEXTEDIT_GETWIDTH_NEWLINE)
@@ -943,7 +1003,7 @@ retry:
                x += dx;
                if (x > goal_x)
                   break;
-               ++state->cursor;
+               state->cursor = STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
             }
             stb_textedit_clamp(str, state);
 
@@ -963,7 +1023,7 @@ retry:
          else {
             int n = STB_TEXTEDIT_STRINGLEN(str);
             if (state->cursor < n)
-               stb_textedit_delete(str, state, state->cursor, 1);
+               stb_textedit_delete(str, state, state->cursor, STB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor) - state->cursor); // [DEAR IMGUI]
          }
          state->has_preferred_x = 0;
          break;
@@ -975,8 +1035,9 @@ retry:
          else {
             stb_textedit_clamp(str, state);
             if (state->cursor > 0) {
-               stb_textedit_delete(str, state, state->cursor-1, 1);
-               --state->cursor;
+               int prev = STB_TEXTEDIT_GETPREVCHARINDEX(str, state->cursor); // [DEAR IMGUI]
+               stb_textedit_delete(str, state, prev, state->cursor - prev);
+               state->cursor = prev;
             }
          }
          state->has_preferred_x = 0;
@@ -1088,6 +1149,8 @@ retry:
 //
 // @OPTIMIZE: the undo/redo buffer should be circular
 
+#ifndef STB_TEXTEDIT_UNDOSTATE // [DEAR IMGUI]
+
 static void stb_textedit_flush_redo(StbUndoState *state)
 {
    state->redo_point = STB_TEXTEDIT_UNDOSTATECOUNT;
@@ -1335,13 +1398,19 @@ static void stb_text_makeundo_replace(STB_TEXTEDIT_STRING *str, STB_TexteditStat
    }
 }
 
+#endif // #ifndef STB_TEXTEDIT_UNDOSTATE
+
 // reset the state to default
 static void stb_textedit_clear_state(STB_TexteditState *state, int is_single_line)
 {
+#ifdef STB_TEXTEDIT_UNDOSTATE
+   stb_text_clearundo(state); // [DEAR IMGUI]
+#else
    state->undostate.undo_point = 0;
    state->undostate.undo_char_point = 0;
    state->undostate.redo_point = STB_TEXTEDIT_UNDOSTATECOUNT;
    state->undostate.redo_char_point = STB_TEXTEDIT_UNDOCHARCOUNT;
+#endif
    state->select_end = state->select_start = 0;
    state->cursor = 0;
    state->has_preferred_x = 0;
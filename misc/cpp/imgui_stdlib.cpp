@@ -8,6 +8,7 @@
 
 // Changelog:
 // - v0.10: Initial version. Added InputText() / InputTextMultiline() calls with std::string
+// - v0.11: Resize callback reserves capacity geometrically and reports it back. Added std::string_view label overloads (C++17).
 
 #include "imgui.h"
 #include "imgui_stdlib.h"
@@ -26,10 +27,16 @@ static int InputTextCallback(ImGuiInputTextCallbackData* data)
     {
         // Resize string callback
         // If for some reason we refuse the new length (BufTextLen) and/or capacity (BufSize) we need to set them back to what we want.
+        // Grow geometrically so typing in a large text doesn't reallocate on every character, then report our actual capacity back so
+        // InputText() can fill it before calling us again. The contents are preserved: InputText() only writes the modified bytes.
         std::string* str = user_data->Str;
         IM_ASSERT(data->Buf == str->c_str());
+        const size_t new_capacity = (size_t)data->BufSize - 1;
+        if (new_capacity > str->capacity())
+            str->reserve(new_capacity > str->capacity() + str->capacity() / 2 ? new_capacity : str->capacity() + str->capacity() / 2);
         str->resize(data->BufTextLen);
         data->Buf = (char*)str->c_str();
+        data->BufSize = (int)str->capacity() + 1;
     }
     else if (user_data->ChainCallback)
     {
@@ -75,3 +82,44 @@ bool ImGui::InputTextWithHint(const char* label, const char* hint, std::string*
     cb_user_data.ChainCallbackUserData = user_data;
     return InputTextWithHint(label, hint, (char*)str->c_str(), str->capacity() + 1, flags, InputTextCallback, &cb_user_data);
 }
+
+#ifdef IMGUI_STDLIB_HAS_STRING_VIEW
+
+// Widgets expect zero-terminated labels: copy them to the stack, only long labels need a heap allocation.
+struct InputTextLabel_Storage
+{
+    char        Buf[128];
+    std::string Fallback;
+
+    const char* Terminate(std::string_view s)
+    {
+        if (s.size() < IM_ARRAYSIZE(Buf))
+        {
+            s.copy(Buf, s.size());
+            Buf[s.size()] = 0;
+            return Buf;
+        }
+        Fallback.assign(s.data(), s.size());
+        return Fallback.c_str();
+    }
+};
+
+bool ImGui::InputText(std::string_view label, std::string* str, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data)
+{
+    InputTextLabel_Storage label_storage;
+    return InputText(label_storage.Terminate(label), str, flags, callback, user_data);
+}
+
+bool ImGui::InputTextMultiline(std::string_view label, std::string* str, const ImVec2& size, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data)
+{
+    InputTextLabel_Storage label_storage;
+    return InputTextMultiline(label_storage.Terminate(label), str, size, flags, callback, user_data);
+}
+
+bool ImGui::InputTextWithHint(std::string_view label, std::string_view hint, std::string* str, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data)
+{
+    InputTextLabel_Storage label_storage, hint_storage;
+    return InputTextWithHint(label_storage.Terminate(label), hint_storage.Terminate(hint), str, flags, callback, user_data);
+}
+
+#endif // #ifdef IMGUI_STDLIB_HAS_STRING_VIEW
@@ -13,6 +13,8 @@
 // - v0.60: (2019/01/10) re-factored to match big update in STB builder. fixed texture height waste. fixed redundant glyphs when merging. support for glyph padding.
 // - v0.61: (2019/01/15) added support for imgui allocators + added FreeType only override function SetAllocatorFunctions().
 // - v0.62: (2019/02/09) added RasterizerFlags::Monochrome flag to disable font anti-aliasing (combine with ::MonoHinting for best results!)
+// - v0.63: (2019/10/20) use ImFontAtlasBuildPackRects() to select the texture width and packing heuristic giving the smallest texture.
+// - v0.64: (2019/10/21) added support for ImFontConfig::Kerning (pairs from the 'kern' table).
 
 // Gamma Correct Blending:
 //  FreeType assumes blending in linear space rather than gamma space.
@@ -317,11 +319,16 @@ bool ImFontAtlasBuildWithFreeType(FT_Library ft_library, ImFontAtlas* atlas, uns
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
 
+    // We don't rasterize glyphs on demand: ignore ImFontAtlasFlags_DynamicGlyphs, which would make ImFontAtlasBuildPackRects()/ImFontAtlasBuildCalcTexHeight()
+    // reserve texture space for them and have the renderer back-end wait for TexDirtyRects.
+    atlas->Flags &= ~ImFontAtlasFlags_DynamicGlyphs;
+
     ImFontAtlasBuildRegisterDefaultCustomRects(atlas);
 
     // Clear atlas
     atlas->TexID = (ImTextureID)NULL;
     atlas->TexWidth = atlas->TexHeight = 0;
+    atlas->TexPackedSurface = 0;
     atlas->TexUvScale = ImVec2(0.0f, 0.0f);
     atlas->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
     atlas->ClearTexData();
@@ -375,7 +382,7 @@ bool ImFontAtlasBuildWithFreeType(FT_Library ft_library, ImFontAtlas* atlas, uns
             dst_tmp.GlyphsSet.Resize(dst_tmp.GlyphsHighest + 1);
 
         for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
-            for (int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
+            for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
             {
                 if (dst_tmp.GlyphsSet.GetBit(codepoint))    // Don't overwrite existing glyphs. We could make this an option (e.g. MergeOverwrite)
                     continue;
@@ -436,7 +443,6 @@ bool ImFontAtlasBuildWithFreeType(FT_Library ft_library, ImFontAtlas* atlas, uns
 
     // 4. Gather glyphs sizes so we can pack them in our virtual canvas.
     // 8. Render/rasterize font characters into the texture
-    int total_surface = 0;
     int buf_rects_out_n = 0;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
     {
@@ -484,48 +490,15 @@ bool ImFontAtlasBuildWithFreeType(FT_Library ft_library, ImFontAtlas* atlas, uns
 
             src_tmp.Rects[glyph_i].w = (stbrp_coord)(src_glyph.Info.Width + padding);
             src_tmp.Rects[glyph_i].h = (stbrp_coord)(src_glyph.Info.Height + padding);
-            total_surface += src_tmp.Rects[glyph_i].w * src_tmp.Rects[glyph_i].h;
         }
     }
 
-    // We need a width for the skyline algorithm, any width!
-    // The exact width doesn't really matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
-    // User can override TexDesiredWidth and TexGlyphPadding if they wish, otherwise we use a simple heuristic to select the width based on expected surface.
-    const int surface_sqrt = (int)ImSqrt((float)total_surface) + 1;
-    atlas->TexHeight = 0;
-    if (atlas->TexDesiredWidth > 0)
-        atlas->TexWidth = atlas->TexDesiredWidth;
-    else
-        atlas->TexWidth = (surface_sqrt >= 4096*0.7f) ? 4096 : (surface_sqrt >= 2048*0.7f) ? 2048 : (surface_sqrt >= 1024*0.7f) ? 1024 : 512;
-
-    // 5. Start packing
-    // Pack our extra data rectangles first, so it will be on the upper-left corner of our texture (UV will have small values).
-    const int TEX_HEIGHT_MAX = 1024 * 32;
-    const int num_nodes_for_packing_algorithm = atlas->TexWidth - atlas->TexGlyphPadding;
-    ImVector<stbrp_node> pack_nodes;
-    pack_nodes.resize(num_nodes_for_packing_algorithm);
-    stbrp_context pack_context;
-    stbrp_init_target(&pack_context, atlas->TexWidth, TEX_HEIGHT_MAX, pack_nodes.Data, pack_nodes.Size);
-    ImFontAtlasBuildPackCustomRects(atlas, &pack_context);
-
-    // 6. Pack each source font. No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
-    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontBuildSrcDataFT& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbrp_pack_rects(&pack_context, src_tmp.Rects, src_tmp.GlyphsCount);
-
-        // Extend texture height and mark missing glyphs as non-packed so we won't render them.
-        // FIXME: We are not handling packing failure here (would happen if we got off TEX_HEIGHT_MAX or if a single if larger than TexWidth?)
-        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
-            if (src_tmp.Rects[glyph_i].was_packed)
-                atlas->TexHeight = ImMax(atlas->TexHeight, src_tmp.Rects[glyph_i].y + src_tmp.Rects[glyph_i].h);
-    }
+    // 5-6. Pack our extra data rectangles and the glyphs of all source fonts. No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
+    // User can override TexDesiredWidth and TexGlyphPadding if they wish, otherwise we try multiple widths and keep the one giving the smallest texture.
+    ImFontAtlasBuildPackRects(atlas, buf_rects.Data, buf_rects_out_n);
 
     // 7. Allocate texture
-    atlas->TexHeight = (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight) ? (atlas->TexHeight + 1) : ImUpperPowerOfTwo(atlas->TexHeight);
+    atlas->TexHeight = ImFontAtlasBuildCalcTexHeight(atlas, atlas->TexWidth, atlas->TexHeight);
     atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
     atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(atlas->TexWidth * atlas->TexHeight);
     memset(atlas->TexPixelsAlpha8, 0, atlas->TexWidth * atlas->TexHeight);
@@ -586,6 +559,25 @@ bool ImFontAtlasBuildWithFreeType(FT_Library ft_library, ImFontAtlas* atlas, uns
             dst_font->AddGlyph((ImWchar)src_glyph.Codepoint, x0, y0, x1, y1, u0, v0, u1, v1, char_advance_x_mod);
         }
 
+        // Bake kerning pairs between the first glyphs of this input. FT_Get_Kerning() only reads the 'kern' table.
+        // We use grid-fitted values (FT_KERNING_DEFAULT) because our glyph advances are rounded to whole pixels as well.
+        if (cfg.Kerning && FT_HAS_KERNING(src_tmp.Font.Face))
+        {
+            const int kerning_glyphs_count = ImMin(src_tmp.GlyphsCount, IM_FONTATLAS_KERNING_GLYPHS_MAX);
+            ImVector<FT_UInt> kerning_glyph_indices;
+            kerning_glyph_indices.resize(kerning_glyphs_count);
+            for (int glyph_i = 0; glyph_i < kerning_glyphs_count; glyph_i++)
+                kerning_glyph_indices[glyph_i] = FT_Get_Char_Index(src_tmp.Font.Face, src_tmp.GlyphsList[glyph_i].Codepoint);
+            for (int left_i = 0; left_i < kerning_glyphs_count; left_i++)
+                for (int right_i = 0; right_i < kerning_glyphs_count; right_i++)
+                {
+                    FT_Vector delta;
+                    if (FT_Get_Kerning(src_tmp.Font.Face, kerning_glyph_indices[left_i], kerning_glyph_indices[right_i], FT_KERNING_DEFAULT, &delta) != 0 || delta.x == 0)
+                        continue;
+                    dst_font->AddKerningPair((ImWchar)src_tmp.GlyphsList[left_i].Codepoint, (ImWchar)src_tmp.GlyphsList[right_i].Codepoint, (float)delta.x / 64.0f);
+                }
+        }
+
         src_tmp.Rects = NULL;
     }
 